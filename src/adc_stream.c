@@ -0,0 +1,147 @@
+/*******************************************************************************************
+ * Expert Tool ICS — DMA-driven ADC sampling (see adc_stream.h)
+ *******************************************************************************************/
+ #include "adc_stream.h"
+ #include <stm32wbxx_ll_adc.h>                   // Regular group: sequence, continuous, DMA request
+ #include <stm32wbxx_ll_dma.h>                   // DMA2 channel 5 + DMAMUX routing
+ #include <string.h>                             // memset
+ 
+ #define ADC_DMA      DMA2                       // DMA1 is used by the firmware's own drivers
+ #define ADC_DMA_CH   LL_DMA_CHANNEL_5
+ #define ADC_CLOCK_HZ 64000000U                  // FuriHalAdcClockSync64
+ #define ADC_VREF_MV  2500U                      // FuriHalAdcScale2500
+ 
+ static const struct {
+     const GpioPin* pin;                         // Header pin, switched to analog
+     uint32_t channel;                           // ADC1 input
+ } kInputs[AdcInputCount] = {
+     [AdcInputPin3] = {&gpio_ext_pa6, LL_ADC_CHANNEL_11},
+     [AdcInputPin7] = {&gpio_ext_pc3, LL_ADC_CHANNEL_4},
+ };
+ 
+ static const struct {
+     uint32_t ll;                                // LL sampling time
+     uint32_t cycles_x2;                         // Sampling + 12.5 conversion cycles, doubled
+ } kRates[AdcRateCount] = {
+     [AdcRateSlow] = {LL_ADC_SAMPLINGTIME_640CYCLES_5, 1306},
+     [AdcRateMid]  = {LL_ADC_SAMPLINGTIME_247CYCLES_5, 520},
+     [AdcRateFast] = {LL_ADC_SAMPLINGTIME_47CYCLES_5,  120},
+     [AdcRateMax]  = {LL_ADC_SAMPLINGTIME_12CYCLES_5,  50},
+ };
+ 
+ static void adc_stream_isr(void* ctx){         // DMA2 CH5: a half (or the whole buffer) is ready
+     AdcStream* st = ctx;
+     const AdcStreamConfig* c = &st->cfg;
+     size_t half = c->len / 2;
+ 
+     if(LL_DMA_IsActiveFlag_TE5(ADC_DMA)){
+         LL_DMA_ClearFlag_TE5(ADC_DMA);
+         st->errors++;
+     }
+     if(LL_DMA_IsActiveFlag_HT5(ADC_DMA)){      // First half filled, DMA now writes the second
+         LL_DMA_ClearFlag_HT5(ADC_DMA);
+         if(c->circular){
+             st->blocks++;
+             c->cb(c->buf, half, c->ctx);
+         }
+     }
+     if(LL_DMA_IsActiveFlag_TC5(ADC_DMA)){      // Second half filled, DMA wraps to the first
+         LL_DMA_ClearFlag_TC5(ADC_DMA);
+         st->blocks++;
+         if(c->circular){
+             c->cb(c->buf + half, half, c->ctx);
+         } else {                                // One-shot: stop converting, hand over everything
+             LL_ADC_REG_StopConversion(ADC1);
+             st->done = true;
+             c->cb(c->buf, c->len, c->ctx);
+         }
+     }
+ }
+ 
+ void adc_stream_start(AdcStream* st, const AdcStreamConfig* cfg){
+     memset(st, 0, sizeof(*st));
+     st->cfg = *cfg;
+ 
+     st->adc = furi_hal_adc_acquire();           // Exclusive use; enables and calibrates ADC1
+     furi_hal_adc_configure_ex(st->adc, FuriHalAdcScale2500, FuriHalAdcClockSync64,
+                               cfg->oversample, FuriHalAdcSamplingtime247_5); // Results stay 12-bit
+ 
+     for(uint8_t i = 0; i < cfg->channels; i++){ // Pins and sequence ranks (ADSTART is 0 here)
+         const uint32_t ch = kInputs[cfg->input[i]].channel;
+         furi_hal_gpio_init(kInputs[cfg->input[i]].pin, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+         LL_ADC_SetChannelSamplingTime(ADC1, ch, kRates[cfg->rate].ll);
+         LL_ADC_REG_SetSequencerRanks(ADC1, i ? LL_ADC_REG_RANK_2 : LL_ADC_REG_RANK_1, ch);
+     }
+     LL_ADC_REG_SetSequencerLength(ADC1,
+         (cfg->channels > 1) ? LL_ADC_REG_SEQ_SCAN_ENABLE_2RANKS : LL_ADC_REG_SEQ_SCAN_DISABLE);
+     LL_ADC_REG_SetTriggerSource(ADC1, LL_ADC_REG_TRIG_SOFTWARE);
+     LL_ADC_REG_SetContinuousMode(ADC1, LL_ADC_REG_CONV_CONTINUOUS); // Back-to-back conversions
+     LL_ADC_REG_SetOverrun(ADC1, LL_ADC_REG_OVR_DATA_OVERWRITTEN);  // Never stall on a late read
+     LL_ADC_REG_SetDMATransfer(ADC1,
+         cfg->circular ? LL_ADC_REG_DMA_TRANSFER_UNLIMITED : LL_ADC_REG_DMA_TRANSFER_LIMITED);
+ 
+     LL_DMA_DisableChannel(ADC_DMA, ADC_DMA_CH);
+     LL_DMA_ConfigTransfer(ADC_DMA, ADC_DMA_CH,
+         LL_DMA_DIRECTION_PERIPH_TO_MEMORY |
+         (cfg->circular ? LL_DMA_MODE_CIRCULAR : LL_DMA_MODE_NORMAL) |
+         LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT |
+         LL_DMA_PDATAALIGN_HALFWORD | LL_DMA_MDATAALIGN_HALFWORD |
+         LL_DMA_PRIORITY_HIGH);
+     LL_DMA_SetPeriphAddress(ADC_DMA, ADC_DMA_CH, LL_ADC_DMA_GetRegAddr(ADC1, LL_ADC_DMA_REG_REGULAR_DATA));
+     LL_DMA_SetMemoryAddress(ADC_DMA, ADC_DMA_CH, (uint32_t)cfg->buf);
+     LL_DMA_SetDataLength(ADC_DMA, ADC_DMA_CH, cfg->len);
+     LL_DMA_SetPeriphRequest(ADC_DMA, ADC_DMA_CH, LL_DMAMUX_REQ_ADC1);
+     LL_DMA_ClearFlag_GI5(ADC_DMA);
+ 
+     furi_hal_interrupt_set_isr(FuriHalInterruptIdDma2Ch5, adc_stream_isr, st);
+     if(cfg->circular) LL_DMA_EnableIT_HT(ADC_DMA, ADC_DMA_CH); // One-shot only needs TC
+     LL_DMA_EnableIT_TC(ADC_DMA, ADC_DMA_CH);
+     LL_DMA_EnableIT_TE(ADC_DMA, ADC_DMA_CH);
+     LL_DMA_EnableChannel(ADC_DMA, ADC_DMA_CH);
+ 
+     LL_ADC_ClearFlag_OVR(ADC1);
+     LL_ADC_REG_StartConversion(ADC1);           // From here on it's hardware only
+ }
+ 
+ void adc_stream_stop(AdcStream* st){
+     if(!st->adc) return;                        // Never started / already stopped
+ 
+     if(LL_ADC_REG_IsConversionOngoing(ADC1)){
+         LL_ADC_REG_StopConversion(ADC1);
+         while(LL_ADC_REG_IsStopConversionOngoing(ADC1));
+     }
+     LL_DMA_DisableIT_HT(ADC_DMA, ADC_DMA_CH);
+     LL_DMA_DisableIT_TC(ADC_DMA, ADC_DMA_CH);
+     LL_DMA_DisableIT_TE(ADC_DMA, ADC_DMA_CH);
+     LL_DMA_DisableChannel(ADC_DMA, ADC_DMA_CH);
+     LL_DMA_ClearFlag_GI5(ADC_DMA);
+     furi_hal_interrupt_set_isr(FuriHalInterruptIdDma2Ch5, NULL, NULL);
+ 
+     LL_ADC_REG_SetDMATransfer(ADC1, LL_ADC_REG_DMA_TRANSFER_NONE); // Leave single-read settings
+     LL_ADC_REG_SetContinuousMode(ADC1, LL_ADC_REG_CONV_SINGLE);
+     LL_ADC_REG_SetSequencerLength(ADC1, LL_ADC_REG_SEQ_SCAN_DISABLE);
+     furi_hal_adc_release(st->adc);              // Disables ADC1 and frees it for others
+     st->adc = NULL;                             // Pins stay analog (Hi-Z)
+ }
+ 
+ static uint32_t oversample_ratio(FuriHalAdcOversample o){
+     switch(o){
+     case FuriHalAdcOversample2:   return 2;
+     case FuriHalAdcOversample4:   return 4;
+     case FuriHalAdcOversample8:   return 8;
+     case FuriHalAdcOversample16:  return 16;
+     case FuriHalAdcOversample32:  return 32;
+     case FuriHalAdcOversample64:  return 64;
+     case FuriHalAdcOversample128: return 128;
+     case FuriHalAdcOversample256: return 256;
+     default:                      return 1;
+     }
+ }
+ 
+ uint32_t adc_stream_rate_hz(const AdcStreamConfig* cfg){
+     return (uint32_t)(2ULL * ADC_CLOCK_HZ / (kRates[cfg->rate].cycles_x2 * oversample_ratio(cfg->oversample)));
+ }
+ 
+ uint16_t adc_stream_to_mv(uint16_t raw){
+     return (uint16_t)((raw * ADC_VREF_MV + 2047U) / 4095U);
+ }
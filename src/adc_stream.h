@@ -0,0 +1,61 @@
+/*******************************************************************************************
+ * Expert Tool ICS — DMA-driven ADC sampling
+ * -----------------------------------------------------------------------------------------
+ * ADC1 converts one or two header pins back to back (continuous mode) and DMA2 channel 5
+ * moves every result into a caller-owned buffer; the CPU never polls the ADC.
+ *   - circular: the buffer is a double buffer; the half-transfer and transfer-complete
+ *     interrupts hand the half that was just filled to the callback while DMA fills the
+ *     other half.
+ *   - one-shot: the buffer is filled once, conversions stop, the callback gets it whole.
+ * Two-channel sequences are interleaved A,B,A,B... Optional hardware oversampling
+ * averages N back-to-back conversions into each delivered sample, so long windows
+ * fit small buffers without any CPU work. The callback runs in interrupt
+ * context and must finish within one half-buffer time.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include <furi_hal.h>                           // FuriHalAdcHandle
+ #include <stdbool.h>                            // bool
+ #include <stddef.h>                             // size_t
+ #include <stdint.h>                             // Fixed-width integers
+ 
+ typedef enum {
+     AdcInputPin3 = 0,                           // Header pin 3 (A6), ADC1_IN11
+     AdcInputPin7,                               // Header pin 7 (C3), ADC1_IN4
+     AdcInputCount,
+ } AdcInput;
+ 
+ typedef enum {
+     AdcRateSlow = 0,                            // 640.5-cycle sampling: ~98 kS/s, high-impedance sources
+     AdcRateMid,                                 // 247.5-cycle sampling: ~246 kS/s
+     AdcRateFast,                                // 47.5-cycle sampling: ~1.07 MS/s
+     AdcRateMax,                                 // 12.5-cycle sampling: ~2.56 MS/s, low-impedance sources only
+     AdcRateCount,
+ } AdcRate;
+ 
+ typedef void (*AdcStreamCallback)(const uint16_t* block, size_t n, void* ctx); // IRQ context
+ 
+ typedef struct {
+     uint8_t channels;                           // 1 or 2
+     AdcInput input[2];                          // Sequence rank 1 / rank 2
+     AdcRate rate;                               // Per-conversion sampling time
+     FuriHalAdcOversample oversample;            // Hardware averaging per delivered sample
+     bool circular;                              // Double buffer (true) or one-shot fill (false)
+     uint16_t* buf;                              // DMA target, 4-byte aligned
+     size_t len;                                 // Samples in buf (multiple of 2 * channels)
+     AdcStreamCallback cb;                       // Block-ready callback
+     void* ctx;                                  // Callback context
+ } AdcStreamConfig;
+ 
+ typedef struct {
+     FuriHalAdcHandle* adc;                      // Held for the whole stream (NULL = stopped)
+     AdcStreamConfig cfg;                        // Active configuration
+     volatile uint32_t blocks;                   // Blocks handed to the callback
+     volatile uint32_t errors;                   // DMA transfer errors
+     volatile bool done;                         // One-shot buffer complete
+ } AdcStream;
+ 
+ void adc_stream_start(AdcStream* st, const AdcStreamConfig* cfg); // Acquire ADC1 and run
+ void adc_stream_stop(AdcStream* st);            // Stop DMA/ADC and release ADC1 (idempotent)
+ uint32_t adc_stream_rate_hz(const AdcStreamConfig* cfg); // Delivered samples/s (all channels together)
+ uint16_t adc_stream_to_mv(uint16_t raw);        // Raw 12-bit sample -> mV (2.5 V reference)
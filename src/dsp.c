@@ -0,0 +1,70 @@
+/*******************************************************************************************
+ * Expert Tool ICS — fixed-point sample kernels (see dsp.h)
+ *******************************************************************************************/
+ #include "dsp.h"
+ 
+ #if defined(__ARM_FEATURE_SIMD32)
+ #include <cmsis_compiler.h>                     // __USUB16, __SEL, __SMLAD
+ 
+ void dsp_lanes_u16(const uint16_t* x, size_t pairs, DspLanes* out){
+     const uint32_t* w = (const uint32_t*)x;     // Two samples per load
+     uint32_t mn = 0xFFFFFFFFU;                  // Both lanes start at the extremes
+     uint32_t mx = 0;
+     uint32_t total = 0;                         // lane0 + lane1 (SMLAD)
+     uint32_t hi = 0;                            // lane1 only
+ 
+     for(size_t i = 0; i < pairs; i++){
+         uint32_t v = w[i];
+         __USUB16(v, mn);                        // GE[lane] = v >= mn
+         mn = __SEL(mn, v);                      // Keep mn where v >= mn, else take v
+         __USUB16(v, mx);                        // GE[lane] = v >= mx
+         mx = __SEL(v, mx);                      // Take v where v >= mx
+         total = (uint32_t)__SMLAD(v, 0x00010001U, (int32_t)total); // lo*1 + hi*1 + acc
+         hi += v >> 16;
+     }
+ 
+     out->min[0] = (uint16_t)mn;  out->min[1] = (uint16_t)(mn >> 16);
+     out->max[0] = (uint16_t)mx;  out->max[1] = (uint16_t)(mx >> 16);
+     out->sum[0] = total - hi;
+     out->sum[1] = hi;
+ }
+ 
+ #else                                           // Portable reference (host builds)
+ 
+ void dsp_lanes_u16(const uint16_t* x, size_t pairs, DspLanes* out){
+     uint16_t mn0 = UINT16_MAX, mn1 = UINT16_MAX, mx0 = 0, mx1 = 0;
+     uint32_t s0 = 0, s1 = 0;
+     for(size_t i = 0; i < pairs; i++){
+         uint16_t a = x[2 * i], b = x[2 * i + 1];
+         if(a < mn0) mn0 = a;
+         if(a > mx0) mx0 = a;
+         if(b < mn1) mn1 = b;
+         if(b > mx1) mx1 = b;
+         s0 += a;
+         s1 += b;
+     }
+     out->min[0] = mn0;  out->min[1] = mn1;
+     out->max[0] = mx0;  out->max[1] = mx1;
+     out->sum[0] = s0;
+     out->sum[1] = s1;
+ }
+ 
+ #endif
+ 
+ void dsp_minmax_columns(const uint16_t* x, size_t n, uint8_t cols, uint16_t* mn, uint16_t* mx){
+     size_t per = n / cols;                      // Samples per column (even: whole pairs)
+     DspLanes l;
+     for(uint8_t c = 0; c < cols; c++){
+         dsp_lanes_u16(x + c * per, per / 2, &l); // Even/odd lanes of one pin: merge them
+         mn[c] = (l.min[0] < l.min[1]) ? l.min[0] : l.min[1];
+         mx[c] = (l.max[0] > l.max[1]) ? l.max[0] : l.max[1];
+     }
+ }
+ 
+ size_t dsp_find_rising(const uint16_t* x, size_t n, uint16_t level, uint16_t hyst){
+     const uint16_t low = (level > hyst) ? (uint16_t)(level - hyst) : 0;
+     size_t i = 0;
+     while(i < n && x[i] >= low) i++;            // Wait until the signal is clearly low
+     while(i < n && x[i] < level) i++;           // Then for it to come back up to the level
+     return i;
+ }
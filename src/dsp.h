@@ -0,0 +1,31 @@
+/*******************************************************************************************
+ * Expert Tool ICS — fixed-point sample kernels
+ * -----------------------------------------------------------------------------------------
+ * Block reductions over raw 12-bit ADC samples (uint16). Samples are processed as
+ * packed pairs (one 32-bit word = two halfword "lanes"): with a two-channel interleaved
+ * sequence each lane is one channel; with a single channel the caller merges the lanes.
+ * On Cortex-M4 the inner loops use the DSP extension (USUB16/SEL for lane-wise
+ * min/max, SMLAD for the sum); elsewhere a portable C loop gives identical results.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include <stddef.h>                             // size_t
+ #include <stdint.h>                             // Fixed-width integers
+ 
+ typedef struct {
+     uint16_t min[2];                            // Per lane minimum
+     uint16_t max[2];                            // Per lane maximum
+     uint32_t sum[2];                            // Per lane sum (avg = sum / pairs)
+ } DspLanes;
+ 
+ /* Reduce `pairs` packed sample pairs. `x` must be 4-byte aligned, pairs > 0,
+  * samples <= 0x7FFF (12-bit ADC data always is). */
+ void dsp_lanes_u16(const uint16_t* x, size_t pairs, DspLanes* out);
+ 
+ /* Decimate a single-channel block to `cols` min/max columns for drawing, reading the
+  * samples in place. n / cols must be even and >= 2; x 4-byte aligned. */
+ void dsp_minmax_columns(const uint16_t* x, size_t n, uint8_t cols, uint16_t* mn, uint16_t* mx);
+ 
+ /* First rising crossing of `level` in x[0..n): the signal must first be below
+  * level - hyst, then reach level. Returns the crossing index, or n if none. */
+ size_t dsp_find_rising(const uint16_t* x, size_t n, uint16_t level, uint16_t hyst);
@@ -14,8 +14,28 @@
  #include <notification/notification.h>          // Notification service: control LEDs, vibration, sound
  #include <notification/notification_messages.h> // Predefined LED sequences (e.g., set/reset RGB)
  #include <dialogs/dialogs.h>                    // Modal dialogs (confirmations, messages)
+ #include <storage/storage.h>                    // SD card (capture export)
  #include <stdbool.h>                            // C99 bool, true/false
  #include <stdio.h>                              // snprintf() for small string formatting
+ #include <string.h>                             // strcmp() for saved profile names
+ #include <toolbox/saved_struct.h>               // Settings file with magic/version/checksum
+ 
+ #include "plot.h"                               // Live frequency/time plot (ring buffer + chart)
+ #include "telemetry.h"                          // Battery / OTG telemetry ring buffer
+ #include "fault_capture.h"                      // TIM2 input capture of the fault line
+ #include "fault_decoder.h"                      // Blink pattern -> fault code state machine
+ #include "adc_stream.h"                         // Continuous / one-shot DMA ADC sampling
+ #include "dsp.h"                                // SIMD min/avg/max block kernel
+ #include "logic_capture.h"                      // Timer-paced DMA port snapshots -> RLE -> VCD
+ #include "onewire.h"                            // 1-Wire bit layer + DS18B20 probe
+ #include "profile_pack.h"                       // Inverter profiles: built-in + SD text files
+ #include "inverter_family.h"                    // Per-brand descriptors (profile, faults, help)
+ #include "model_db.h"                           // Label code -> family + speed range (flash)
+ #include "run_log.h"                            // Session log on SD (writer thread)
+ #include "run_db.h"                             // Run hours per compressor serial (SD)
+ #include "help_text.h"                          // Compressed help lines + decode cache
+ #include "help_file.h"                          // Help documents streamed from SD
+ #include "load_play.h"                          // Load-profile playback from SD
  
  /*** PWM wiring (Flipper external header):
   *  + signal: PA7 (external pin "2 (A7)")
@@ -39,6 +59,8 @@
      SCROLLBAR_Y1    = 62,                       // Bottom Y of the scrollbar rail
  
      TIMER_MARGIN    = 6,                        // Gap between right-aligned timer text and rail
+ 
+     ROWS_VISIBLE    = 4,                        // List rows shown at once below the title
  };
  
  /* ---------- Safe GPIO helpers ---------- */
@@ -70,128 +92,298 @@
      }
  }
  
- /* Start PWM at freq_hz with 50% duty; update flag if provided */
- static inline void pwm_hw_start_safe(uint32_t freq_hz, bool* running) {
-     furi_hal_pwm_start(PWM_CH, freq_hz, 50);    // HAL: start PWM (freq in Hz, 50% duty cycle)
+ /* Start PWM at freq_hz with the profile's duty; update flag if provided */
+ static inline void pwm_hw_start_safe(uint32_t freq_hz, uint8_t duty_pct, bool* running) {
+     furi_hal_pwm_start(PWM_CH, freq_hz, duty_pct); // HAL: start PWM (freq in Hz, duty in %)
      if(running) *running = true;                // Mark as running if a flag pointer was passed
  }
  
  /* ---------- 5V helpers (OTG boost control) ---------- */
- /* "InverterId" identifies which inverter profile is active (affects 5V boost on Samsung) */
- typedef enum {
-     InvEmbraco = 0,                             // Embraco inverter family
-     InvSamsung = 1,                             // Samsung inverter family (requires OTG 5V)
- } InverterId;
- 
- /* Enable/disable 5V only for Samsung (no-op for Embraco) */
- static inline void inverter_power_5v(InverterId inv, bool on){
-     if(inv == InvSamsung){                      // Only Samsung uses OTG 5V boost
+ /* Enable/disable 5V only for profiles that need it (no-op otherwise, e.g. Embraco) */
+ static inline void inverter_power_5v(const Profile* p, bool on){
+     if(p->needs_5v){                            // Only these use the OTG 5V boost
          if(on)  furi_hal_power_enable_otg();    // HAL: request USB-OTG 5V rail ON
          else    furi_hal_power_disable_otg();   // HAL: request USB-OTG 5V rail OFF
      }
  }
  
+ /* Rail-good check: boost output (read back on VBUS by the charger ADC) is up and no fault */
+ #define OTG_RAIL_GOOD_V        4.6f             // Minimum VBUS voltage accepted as "rail good"
+ #define OTG_SETTLE_TIMEOUT_MS  300              // Give up (clean failure) after this long
+ #define OTG_POLL_MS            2                // Poll interval while waiting
+ 
+ static bool otg_rail_good(void){
+     if(furi_hal_power_check_otg_fault()) return false; // Boost converter reported a fault
+     return furi_hal_power_get_usb_voltage() >= OTG_RAIL_GOOD_V;
+ }
+ 
+ /* Enable 5V (profiles that need it) and block until the rail is good or the timeout
+  * expires. Returns false (with OTG switched back off) on timeout. *settle_ms receives the
+  * measured settle time; it is left untouched when no switch-on was needed. */
+ static bool inverter_power_5v_wait(const Profile* p, uint32_t* settle_ms){
+     if(!p->needs_5v) return true;               // e.g. Embraco needs no 5V
+     if(furi_hal_power_is_otg_enabled() && otg_rail_good()) return true; // Already up
+ 
+     uint32_t t0 = furi_get_tick();              // Start of settle window
+     inverter_power_5v(p, true);                 // Request OTG 5V
+     while(!otg_rail_good()){                    // Poll until VBUS is in range
+         if(furi_get_tick() - t0 >= furi_ms_to_ticks(OTG_SETTLE_TIMEOUT_MS)){
+             inverter_power_5v(p, false);        // Bad unit: leave the rail off
+             return false;
+         }
+         furi_delay_ms(OTG_POLL_MS);
+     }
+     if(settle_ms) *settle_ms = (furi_get_tick() - t0) * 1000U / furi_kernel_get_tick_frequency();
+     return true;
+ }
+ 
  /* Universal 5V switch used for safety cleanup (mostly turning it OFF) */
  static inline void power_5v_set(bool on){
      if(on)  furi_hal_power_enable_otg();        // Force OTG 5V ON
      else    furi_hal_power_disable_otg();       // Force OTG 5V OFF
  }
  
- /* ---------- Powered modes table ---------- */
- typedef struct {
-     const char* name;                           // Row label to display
-     uint32_t    freq_hz;                        // PWM frequency (0 => Stand by = no PWM)
-     uint8_t     led_blink_hz;                   // LED blink frequency (0 => LED off)
-     uint32_t    default_secs;                   // Auto-off seconds (if limit_runtime == true)
- } Mode;
- 
- /* Embraco defaults — ONLY ONE CHANGE: Max 160 -> 150 (see last entry) */
- static const Mode kModes[] = {
-     {"Stand by", 0,   0,   0},                  // 0: No PWM, pin forced LOW, no timer
-     {"Low speed", 55, 1, 120},                  // 1: 55 Hz PWM, LED 1 Hz, 2 minutes limit
-     {"Mid speed", 100,2,  60},                  // 2: 100 Hz PWM, LED 2 Hz, 1 minute limit
-     {"Max speed", 150,4,  30},                  // 3: 150 Hz PWM, LED 4 Hz, 30 seconds limit  // CHANGED
- };
- #define MODE_COUNT (sizeof(kModes)/sizeof(kModes[0])) // Compute number of entries at compile-time
- 
- /* ---------- Help text (per inverter) ---------- */
- static const char* HELP_EMBRACO[] = {           // Embraco help lines (scrollable plain strings)
-     "Connect wires as follows:",
-     "",
-     "2 (A7)    -> inverter +",
-     "(usually RED wire)",
-     "8 (GND)  -> inverter -",
-     "(usually WHITE wire)",
-     "",
-     "Note:",
-     "This app provides",
-     "3 test speeds:",
-     "",
-     "Low speed:",
-     "2000 RPM (VNE)",
-     "1800 RPM (VEG, FMF)",
-     "",
-     "Mid speed:",
-     "3000 RPM",
-     "(VNE, VEG, FMF)",
-     "",
-     "Max speed:",
-     "4500 RPM",
-     "(VNE, VEG, FMF)",
-     "",
-     "Embraco compressors",
-     "support many speeds",
-     "with 30 RPM steps.",
-     "",
-     "----------------",
-     "",
-     "App created by",
-     "Adam Gray",
-     "Founder of",
-     "Expert Hub",
-     "experthub.app",
-     "",
-     "----------------",
-     "",
-     "Press BACK to start.",
- };
- #define HELP_EMBRACO_COUNT (sizeof(HELP_EMBRACO)/sizeof(HELP_EMBRACO[0])) // Number of Embraco lines
+ /* ---------- Passive inverter detection (PA7 is never driven) ---------- */
+ /* Only the internal ~40 kΩ pull resistors are switched while PA7 stays an input:
+  *  - rise time with pull-up / fall time with pull-down: a line that cannot be pulled
+  *    up is clamped by a load to GND (Embraco: optocoupler LED between + and -); one
+  *    that cannot be pulled down is biased by the inverter board itself (Samsung);
+  *  - edges seen on the lightly pulled-down input: the board is actively signalling.
+  * Result is a hint for the first screen; the technician still confirms with OK. */
+ #define PROBE_HOLD_US      1000                 // Pull can't move the line in 1 ms: it's held
+ #define PROBE_FAST_US      20                   // Both edges faster: nothing attached
+ #define PROBE_ACTIVITY_MS  200                  // Watch window for an active signal
+ #define PROBE_ACTIVE_EDGES 4                    // Edges in that window that mean "driven"
  
- static const char* HELP_SAMSUNG[] = {           // Samsung help placeholder
-     "In development",
+ typedef enum {
+     ProbeOpen = 0,                              // Bare pin / lead only
+     ProbeLoaded,                                // Something attached, no clear signature
+     ProbeHeldLow,                               // Clamped low against the pull-up
+     ProbeHeldHigh,                              // Held high against the pull-down
+     ProbeActive,                                // Toggling by itself
+ } ProbeResult;
+ 
+ static const struct {
+     int8_t inverter;                            // InverterId guess (-1 = no guess)
+     const char* hint;                           // Ribbon text on the first screen
+ } kProbeGuess[] = {                             // Indexed by ProbeResult
+     [ProbeOpen]     = {-1,         "PA7: nothing detected"},
+     [ProbeLoaded]   = {-1,         "PA7: unknown load"},
+     [ProbeHeldLow]  = {InvEmbraco, "Looks like Embraco"},
+     [ProbeHeldHigh] = {InvSamsung, "Looks like Samsung"},
+     [ProbeActive]   = {InvSamsung, "Active line: Samsung?"},
  };
- #define HELP_SAMSUNG_COUNT (sizeof(HELP_SAMSUNG)/sizeof(HELP_SAMSUNG[0])) // Number of Samsung lines
+ 
+ static uint32_t probe_settle_us(GpioPull pull, bool level){ // Switch pull, time the line
+     const uint32_t ipus = furi_hal_cortex_instructions_per_microsecond();
+     furi_hal_gpio_init(PWM_PIN, GpioModeInput, pull, GpioSpeedLow); // Still an input
+     const uint32_t t0 = DWT->CYCCNT;
+     while(furi_hal_gpio_read(PWM_PIN) != level){
+         if(DWT->CYCCNT - t0 > PROBE_HOLD_US * ipus) return UINT32_MAX; // Held
+     }
+     return (DWT->CYCCNT - t0) / ipus;
+ }
+ 
+ static ProbeResult inverter_probe(void){        // ~205 ms worst case
+     probe_settle_us(GpioPullDown, false);       // Known starting level (if it can get there)
+     uint32_t rise_us = probe_settle_us(GpioPullUp, true);
+     uint32_t fall_us = probe_settle_us(GpioPullDown, false);
+ 
+     uint16_t edges = 0;                         // Pull-down stays on: floating noise reads 0
+     bool prev = furi_hal_gpio_read(PWM_PIN);
+     const uint32_t t_end = furi_get_tick() + furi_ms_to_ticks(PROBE_ACTIVITY_MS);
+     while((int32_t)(furi_get_tick() - t_end) < 0 && edges < PROBE_ACTIVE_EDGES){
+         bool now = furi_hal_gpio_read(PWM_PIN);
+         if(now != prev){ edges++; prev = now; }
+     }
+     pin_to_hiz();                               // Back to plain Hi-Z
+ 
+     if(edges >= PROBE_ACTIVE_EDGES) return ProbeActive;
+     if(rise_us == UINT32_MAX) return ProbeHeldLow;
+     if(fall_us == UINT32_MAX) return ProbeHeldHigh;
+     if(rise_us <= PROBE_FAST_US && fall_us <= PROBE_FAST_US) return ProbeOpen;
+     return ProbeLoaded;
+ }
+ 
+ /* ---------- Inverter profiles (built-in + SD card) ---------- */
+ /* Built-ins (one per family, kInverterFamilies) come first in the inverter list
+  * (index == InverterId), then the SD pack.
+  * Extra profiles: one text file each in PROFILE_DIR (format in profile_pack.h). */
+ #define PROFILE_DIR   EXT_PATH("apps_data/expert_tool_ics/profiles")
+ #define PROFILE_CACHE EXT_PATH("apps_data/expert_tool_ics/profiles.bin")
+ 
+ /* Highest frequency any mode commands on this profile (plot full-scale) */
+ static uint32_t profile_freq_max(const Profile* p){
+     uint32_t max = 0;
+     for(uint8_t i = 0; i < p->mode_count; i++){
+         if(p->modes[i].freq_hz > max) max = p->modes[i].freq_hz;
+     }
+     return max;
+ }
  
  /* ---------- Screens (state machine) ---------- */
  typedef enum {
-     ScreenSelectInverter = 0,                   // First screen: pick Embraco or Samsung
+     ScreenSelectInverter = 0,                   // First screen: pick the inverter / profile
      ScreenMenu,                                 // Main menu (safe or powered variant)
      ScreenHelp,                                 // Scrollable help view
      ScreenSettings,                             // Settings screen (toggles + inverter selection)
+     ScreenPlot,                                 // Live frequency/time chart
+     ScreenBattery,                              // Battery / OTG telemetry status
+     ScreenFault,                                // Live inverter fault-code reader
+     ScreenAnalog,                               // Header ADC pins: min/avg/max voltage
+     ScreenInrush,                               // Burst capture after each speed change
+     ScreenScope,                                // Mini oscilloscope on pin 3
+     ScreenLogic,                                // Logic analyzer on pins 2/3/4
+     ScreenRunHours,                             // Cumulative runtime of one compressor serial
+     ScreenModel,                                // Model code lookup -> speed ladder
+     ScreenPlayback,                             // Load-profile playback from SD
  } ScreenId;
  
+ /* ---------- Performance counters (HUD) ---------- */
+ /* Raw counters are bumped from the main loop, draw callback, timer callbacks and
+  * apply_mode(); perf_roll() publishes them once per second for the overlay. */
+ typedef struct {
+     uint32_t window_start;                      // Tick when the current 1 s window began
+     uint32_t loops;                             // Main loop wakeups in this window
+     uint32_t frames;                            // draw_cb() calls in this window
+     uint32_t draw_cyc_sum;                      // Sum of draw durations (CPU cycles)
+     uint32_t draw_cyc_max;                      // Longest draw (CPU cycles)
+     uint32_t jitter_cyc_max;                    // Worst timer period error (CPU cycles)
+     uint32_t timer_prev_cyc;                    // Cycle stamp of previous sampler callback
+     uint32_t input_cyc;                         // Cycle stamp of the input being handled (0 = none)
+ 
+     uint16_t loops_ps;                          // Published: loop wakeups per second
+     uint16_t frames_ps;                         // Published: frames per second
+     uint32_t draw_avg_us;                       // Published: average draw time
+     uint32_t draw_max_us;                       // Published: max draw time
+     uint32_t latency_us;                        // Published: input -> apply_mode() done
+     uint32_t jitter_us;                         // Published: timer callback jitter
+     uint32_t free_heap;                         // Published: free heap bytes
+ } PerfStats;
+ 
+ static inline uint32_t perf_cycles(void){ return DWT->CYCCNT; } // Free-running CPU cycle counter
+ static inline uint32_t perf_cyc_to_us(uint32_t cyc){             // Cycles -> microseconds
+     return cyc / furi_hal_cortex_instructions_per_microsecond();
+ }
+ 
+ /* ---------- Hardware LED blink ---------- */
+ /* The mode LED blinks in the LED driver itself: led_apply() sends one notification per
+  * mode change and nothing per half-period, so the steady-state cost is zero. */
+ #define LED_HZ_UNKNOWN 0xFF                     // Forces the first led_apply() to send
+ 
+ typedef struct {
+     NotificationMessage blink;                  // LedBlinkStart: on-time, period, colour
+     const NotificationMessage* seq[2];          // {&blink, NULL}: a NotificationSequence
+ } LedBlinkSlot;
+ 
  /* ---------- Application runtime state ---------- */
+ #define RUN_SERIAL_LEN 13                       // Compressor serial incl. NUL
+ 
  typedef struct {
      ScreenId screen;                            // Current screen
-     InverterId inverter;                        // Selected inverter profile
+     uint8_t profile;                            // Selected profile: built-ins, SD pack or PROFILE_MODEL
+     Profile model_profile;                      // Ladder built from the model database
+     const InverterFamily* family;               // Brand descriptor of that profile
+     ProfilePack profiles;                       // Profiles loaded from the SD card
      bool powered;                               // false => SAFE menu; true => POWERED menu
  
      uint8_t cursor;                             // Selected row index within the visible window
      uint8_t first_visible;                      // Top row index in the 4-row window
-     uint8_t active;                             // Active powered mode (0..MODE_COUNT-1)
+     uint8_t active;                             // Active powered mode (0..mode_count-1)
  
-     uint8_t help_top_line;                      // Scroll offset for help text (top visible line)
+     uint16_t help_top_line;                     // Scroll offset for help text (top visible line)
+     HelpCache* help_cache;                      // Visible help lines (filled by the main loop for SD docs)
+     HelpFile* volatile help_file;               // SD help document while the help screen is open
+     uint16_t help_file_lines;                   // Its line count: draw_help() never dereferences it
  
      bool limit_runtime;                         // If true, enforce per-mode timeout
      bool arrow_captcha;                         // Placeholder toggle (UI only)
  
      NotificationApp* notif;                     // Notification (LED) service handle
-     FuriTimer* led_timer;                       // LED blink timer (periodic)
-     bool led_on;                                // Current LED state (toggled by timer)
+     LedBlinkSlot led_slots[2];                  // Blink messages handed to the notification thread
+     uint8_t led_slot;                           // Slot to fill on the next change
+     uint8_t led_hz;                             // Blink rate currently running (LED_HZ_UNKNOWN at start)
  
      bool pwm_running;                           // Tracks whether PWM is currently running
+     uint32_t freq_hz;                           // Commanded PWM frequency (0 => no output)
+ 
+     Plot* plot;                                 // Sample history + chart bitmap (heap: ~1.8 KB)
+     FuriTimer* plot_timer;                      // Periodic plot sampler
+ 
+     bool perf_hud;                              // Draw the performance overlay
+     PerfStats perf;                             // HUD counters
+ 
+     uint8_t dark_idx;                           // Dark-run delay choice (index into kDarkAfterS)
+     bool dark;                                  // Backlight off, UI redraws suppressed
+     bool wake_swallow;                          // Ignore the waking key until it is released
+     uint32_t last_input_tick;                   // Tick of the most recent key event
+     uint32_t dark_sample_tick;                  // Tick of the last dark-mode current sample
+     int32_t dark_ma_sum;                        // Sum of battery draw samples while dark
+     uint16_t dark_ma_count;                     // Number of samples in dark_ma_sum
+     int16_t lit_ma;                             // Last measured draw with display on (-1 = n/a)
+     int16_t dark_ma;                            // Last measured average draw while dark (-1 = n/a)
+ 
+     Telemetry* telemetry;                       // Fuel-gauge sample ring (heap)
+     uint8_t telem_idx;                          // Sampling period choice (index into kTelemetryPeriodS)
+     uint32_t runtime_est_s;                     // Battery runtime estimate (TELEMETRY_RUNTIME_UNKNOWN = hide)
+     uint32_t otg_settle_ms;                     // Last measured OTG 5V settle time (0 = n/a)
+     bool rail_lost;                             // Set by apply_mode() / play_poll(); consumed in main loop
+ 
+     struct FaultReader* fault;                  // Capture + decoder while the fault screen is open
+ 
+     uint8_t analog_cfg;                         // Analog inputs: 0 = off, 1 = pin 3, 2 = pins 3 + 7
+     struct AnalogMon* analog;                   // DMA double buffer + block stats (NULL = off)
+     uint32_t analog_pub_tick;                   // Tick of the last published analog window
+     int16_t analog_mv;                          // Pin 3 window average for the plot (PLOT_NO_VALUE = off)
+ 
+     struct Inrush* inrush;                      // Burst buffer + last result (NULL = disarmed)
+     bool inrush_pending;                        // Set by apply_mode() / play_poll(); consumed in main loop
+     bool adc_burst;                             // A burst owns ADC1; the monitor waits for it
+ 
+     struct Scope* scope;                        // Oscilloscope buffers (NULL = scope closed)
+     LogicCapture* logic;                        // Logic analyzer buffers (NULL = screen closed)
+     uint8_t logic_rate_idx;                     // Snapshot rate choice (index into kLogicRateHz)
+ 
+     LoadPlay* play;                             // Playback file buffer (NULL = not playing)
+     FuriTimer* play_timer;                      // Scheduler: retunes PWM at each breakpoint
+     uint32_t play_t0;                           // Tick playback started
+     uint32_t play_pos_ms;                       // Scaled position, published by the scheduler
+     volatile uint32_t play_hz;                  // Scheduler: commanded speed (main loop mirrors it)
+     volatile bool play_pwm_on;                  // Scheduler: PWM unit running (pwm_running while playing)
+     volatile uint16_t play_seq;                 // Scheduler: speed changes applied
+     uint16_t play_seq_seen;                     // Main loop: changes already armed for inrush
+     uint32_t play_points;                       // Breakpoints applied
+     uint32_t play_late;                         // Scheduler ticks that found the buffer empty
+     bool play_done;                             // Set by the scheduler; consumed in main loop
+     uint8_t play_scale_idx;                     // Time scale choice (index into kPlayScale)
+     uint16_t play_file;                         // Selected file (directory order)
+     uint16_t play_files;                        // Files found in PLAY_DIR
+     char play_name[64];                         // Selected file name ("" = none)
+ 
+     bool temp_probe;                            // DS18B20 on pin 17 enabled (Settings)
+     Ds18b20 ds;                                 // Probe state machine
+     int16_t temp_dc;                            // Fresh reading for the plot (PLOT_NO_VALUE = none)
+ 
+     uint32_t nav_press_tick;                    // Tick when UP/DOWN went down (hold-to-scroll accel)
+ 
+     RunLog* log;                                // Session log ring + writer (heap)
+ 
+     char serial[RUN_SERIAL_LEN];                // Compressor under test ("" = not tracked)
+     RunDb* runs;                                // Run-hours journal index (heap)
+     uint8_t seg_mode;                           // Mode of the open run segment (0 = none)
+     uint32_t seg_tick;                          // Tick the open segment started
+     RunDbTotals unit;                           // Last lookup for the Run hours screen
+     bool unit_found;                            // unit is valid
+     bool serial_edit;                           // Run hours screen is editing the serial
+     uint8_t serial_pos;                         // Caret position while editing
+     char model_query[MODEL_CODE_LEN];           // Model lookup: typed start of a label code
+     uint8_t model_pos;                          // Caret position in model_query
+ 
+     bool settings_dirty;                        // Saved settings differ from flash
+     uint32_t settings_tick;                     // Tick of the last settings change
  
      bool hint_visible;                          // If true, draw the bottom hint ribbon
+     const char* hint_msg;                       // Text shown in the ribbon
      FuriTimer* hint_timer;                      // One-shot timer to auto-hide the hint
  
      FuriTimer* tick_timer;                      // 1 Hz countdown tick timer
@@ -204,35 +396,112 @@
      FuriMessageQueue* q;                        // Input event queue for main loop
  } AppState;
  
- /* ---------- LED helpers ---------- */
- static void led_set(NotificationApp* n, bool on){ // Drive LED using Notification sequences
-     if(!n) return;                               // Guard: notification service may be NULL
-     if(on) notification_message(n, &sequence_set_green_255); // Set green LED full brightness
-     else   notification_message(n, &sequence_reset_rgb);     // Reset LEDs (off)
+ /* ---------- Active profile ---------- */
+ #define PROFILE_MODEL 0xFF                      // s->profile: model_profile (not a list row)
+ 
+ static const Profile* profile_at(const AppState* s, uint8_t idx){ // Inverter list row
+     if(idx == PROFILE_MODEL) return &s->model_profile;
+     if(idx < InvCount) return &kInverterFamilies[idx].profile;
+     return &s->profiles.items[idx - InvCount];
+ }
+ 
+ static const Profile* active_profile(const AppState* s){ return profile_at(s, s->profile); }
+ 
+ static uint8_t profile_row(const AppState* s){   // List row for a caret: a model -> its family
+     if(s->profile != PROFILE_MODEL) return s->profile;
+     return (s->model_profile.family < InvCount) ? s->model_profile.family : InvEmbraco; // As inverter_family_get()
  }
- static void led_timer_cb(void* ctx){             // Called periodically to toggle LED state
-     AppState* s = ctx;                           // Recover app state pointer from timer context
-     s->led_on = !s->led_on;                      // Flip LED boolean
-     led_set(s->notif, s->led_on);                // Apply new LED state
+ 
+ static uint8_t profile_total(const AppState* s){ // Rows in the inverter list
+     return (uint8_t)(InvCount + s->profiles.count);
  }
- static void led_apply(AppState* s, uint8_t blink_hz){ // Start/stop LED blinking according to mode
-     if(s->led_timer){                            // If a previous timer exists
-         furi_timer_stop(s->led_timer);           // -> stop it
-         furi_timer_free(s->led_timer);           // -> free it
-         s->led_timer = NULL;                     // -> clear pointer
+ 
+ static void select_profile(AppState* s, uint8_t idx){ // Profile + its brand descriptor
+     s->profile = idx;
+     s->family = inverter_family_get(active_profile(s)->family);
+ }
+ 
+ static void select_model(AppState* s, uint16_t i){ // Model's own ladder, else its family's
+     if(model_db_profile(i, &s->model_profile)) select_profile(s, PROFILE_MODEL);
+     else select_profile(s, s->model_profile.family); // Built-in row of that family
+ }
+ 
+ /* ---------- Temperature text ---------- */
+ /* 0.1 °C -> "-0.5C". The sign is printed on its own: dc / 10 is 0 from -0.9 to -0.1. */
+ static const char* temp_str(char* out, size_t cap, int16_t dc){
+     int mag = (dc < 0) ? -dc : dc;
+     snprintf(out, cap, "%s%d.%dC", (dc < 0) ? "-" : "", mag / 10, mag % 10);
+     return out;
+ }
+ 
+ /* ---------- Run log ---------- */
+ #define RUN_LOG_DIR EXT_PATH("apps_data/expert_tool_ics/logs")
+ 
+ static void log_event(AppState* s, RunLogKind kind, uint16_t freq_hz, const char* text){
+     if(s->log) run_log_event(s->log, kind, freq_hz, text); // Ring push only: no storage here
+ }
+ 
+ static void telemetry_log_sink(const TelemetrySample* t, void* ctx){ // Main loop, each sample
+     AppState* s = ctx;
+     if(!s->powered) return;                     // Unpowered sessions leave no log file
+     char text[RUN_LOG_TEXT];                    // Copied by run_log_event()
+     char temp[10];                              // "-3276.8C" at worst
+     snprintf(text, sizeof(text), "%u mV %d mA %s", t->batt_mv, t->batt_ma,
+         temp_str(temp, sizeof(temp), t->temp_dc));
+     log_event(s, RunLogBattery, 0, text);
+ }
+ 
+ /* ---------- Output state ---------- */
+ static bool output_running(const AppState* s){  // PA7 driven: a mode, or a playback's scheduler
+     return s->pwm_running || s->play_pwm_on;
+ }
+ 
+ /* ---------- Run-hours tracking ---------- */
+ /* Every stretch of PWM in one mode is one journal record for the unit in s->serial.
+  * Closing a segment only updates RAM; the journal is written while the output is off. */
+ #define RUNS_DIR EXT_PATH("apps_data/expert_tool_ics")
+ static void runs_segment_end(AppState* s){
+     if(s->seg_mode == 0) return;                // No PWM segment open
+     uint32_t secs = (furi_get_tick() - s->seg_tick) / furi_kernel_get_tick_frequency();
+     if(s->runs && s->serial[0] && secs > 0){
+         run_db_append(s->runs, run_db_hash(s->serial), s->seg_mode, secs, furi_hal_rtc_get_timestamp());
      }
-     s->led_on = false;                           // Reset LED state
-     led_set(s->notif, false);                    // Turn LED off
+     s->seg_mode = 0;
+ }
  
-     if(blink_hz == 0) return;                    // No blink requested: done
+ static void runs_segment_start(AppState* s, uint8_t mode){
+     s->seg_mode = mode;
+     s->seg_tick = furi_get_tick();
+ }
  
-     uint32_t ms = 1000U / (blink_hz * 2U);       // Toggle period = half cycle (on/off)
-     if(ms == 0) ms = 1;                          // Safety clamp against division rounding
-     s->led_timer = furi_timer_alloc(             // Create a periodic timer
-         led_timer_cb,                            // -> callback to toggle LED
-         FuriTimerTypePeriodic,                   // -> periodic mode
-         s);                                      // -> context back to our AppState
-     furi_timer_start(s->led_timer, furi_ms_to_ticks(ms)); // Arm timer with computed period
+ /* ---------- Redraw gate ---------- */
+ static void ui_refresh(AppState* s){            // All redraw requests go through here
+     if(s->vp && !s->dark) view_port_update(s->vp); // Dark run: screen is frozen, no redraws
+ }
+ 
+ /* ---------- LED helpers ---------- */
+ static void led_apply(AppState* s, uint8_t blink_hz){ // Start/stop LED blinking according to mode
+     if(!s->notif) return;                        // Guard: notification service may be NULL
+     if(blink_hz == s->led_hz) return;            // Same pattern already running: no message
+     s->led_hz = blink_hz;                        // Remember what the LED is doing
+
+     if(blink_hz == 0){                           // No blink requested
+         notification_message(s->notif, &sequence_blink_stop); // Stop hardware blink engine
+         notification_message(s->notif, &sequence_reset_rgb);  // Make sure the LED is dark
+         return;
+     }
+
+     LedBlinkSlot* slot = &s->led_slots[s->led_slot]; // Alternate slots: the notification
+     s->led_slot ^= 1;                            // thread may still hold the previous one
+     uint16_t period = (uint16_t)(1000U / blink_hz); // Full on+off cycle in ms
+     if(period < 2) period = 2;                   // Safety clamp against division rounding
+     slot->blink.type = NotificationMessageTypeLedBlinkStart; // Driver-timed blink
+     slot->blink.data.led_blink.on_time = (uint16_t)(period / 2); // 50% on
+     slot->blink.data.led_blink.period  = period;
+     slot->blink.data.led_blink.color   = LightGreen;
+     slot->seq[0] = &slot->blink;                 // {&blink, NULL} forms the sequence
+     slot->seq[1] = NULL;
+     notification_message(s->notif, (const NotificationSequence*)slot->seq); // Once per mode change
  }
  
  /* ---------- Dotted scrollbar renderer ---------- */
@@ -269,13 +538,13 @@
      AppState* s = ctx;                           // Recover state
      if(s->remaining_ms >= 1000) s->remaining_ms -= 1000; // Subtract 1 second if possible
      else s->remaining_ms = 0;                    // Clamp at 0
-     if(s->vp) view_port_update(s->vp);           // Trigger redraw so title timer updates
+     ui_refresh(s);                               // Trigger redraw so title timer updates
  }
  static void off_timer_cb(void* ctx){             // One-shot expiry handler
      AppState* s = ctx;                           // Recover state
      s->remaining_ms = 0;                         // Ensure timer shows as zero
      s->timeout_expired = true;                   // Signal main loop to switch to Stand by
-     if(s->vp) view_port_update(s->vp);           // Ask GUI to refresh immediately
+     ui_refresh(s);                               // Ask GUI to refresh immediately
  }
  static void stop_timers(AppState* s){            // Stop both countdown timers if active
      if(s->tick_timer) furi_timer_stop(s->tick_timer); // Stop tick timer (keeps allocated)
@@ -294,7 +563,7 @@
      if(!s->limit_runtime) return;                 // If limit disabled, no timers
      if(s->active == 0) return;                    // Stand by (index 0) never has a timer
  
-     uint32_t secs = kModes[s->active].default_secs; // Pull per-mode default seconds
+     uint32_t secs = active_profile(s)->modes[s->active].auto_off_s; // Per-mode default seconds
      if(secs == 0) return;                         // 0 means unlimited: no timers
  
      s->remaining_ms = secs * 1000U;               // Convert seconds -> milliseconds
@@ -308,21 +577,81 @@
      furi_timer_start(s->off_timer,  furi_ms_to_ticks(s->remaining_ms)); // Start one-shot
  }
  
+ /* ---------- Load-profile playback: scheduler ---------- */
+ /* While a file plays, the periodic timer below is the only code that touches PWM: it
+  * walks the breakpoints by elapsed time and retunes at each one, so redraws and SD reads
+  * never shift a speed change. It only retunes: no I2C, no delays, and its state lives in
+  * the play_* fields. The main loop refills the file buffer (load_play.h), checks the 5V
+  * rail and mirrors the commanded speed into freq_hz / inrush_pending (play_poll). */
+ #define PLAY_DIR     EXT_PATH("apps_data/expert_tool_ics/playback")
+ #define PLAY_TICK_MS 20                         // Breakpoint timing resolution
+ 
+ static const uint8_t kPlayScale[] = {1, 10, 60}; // Time compression: 24 h in 24 h / 2.4 h / 24 min
+ #define PLAY_SCALE_COUNT (sizeof(kPlayScale)/sizeof(kPlayScale[0]))
+ 
+ static void play_set_freq(AppState* s, uint32_t hz){ // Scheduler: retune at a breakpoint
+     if(hz == s->play_hz) return;
+     uint8_t duty = active_profile(s)->duty_pct;
+     if(hz == 0){                                // 0 Hz: output stopped, pin held LOW
+         if(s->play_pwm_on) furi_hal_pwm_stop(PWM_CH);
+         pin_to_pp_low();
+         s->play_pwm_on = false;
+     } else if(s->play_pwm_on){
+         furi_hal_pwm_set_params(PWM_CH, hz, duty); // Retune in place: no stop/start gap
+     } else {
+         furi_hal_pwm_start(PWM_CH, hz, duty);
+         s->play_pwm_on = true;
+     }
+     s->play_hz = hz;
+     s->play_seq++;                              // Main loop arms the inrush burst
+ }
+ 
+ static void play_timer_cb(void* ctx){           // Scheduler tick (timer thread)
+     AppState* s = ctx;
+     LoadPlay* lp = s->play;
+     if(!lp || s->play_done) return;
+     uint32_t ms = (uint32_t)((uint64_t)(furi_get_tick() - s->play_t0) * 1000U *
+         kPlayScale[s->play_scale_idx] / furi_kernel_get_tick_frequency());
+ 
+     const LoadPoint* pt;
+     int32_t hz = -1;                            // Late tick: only the newest due point applies
+     while((pt = load_play_peek(lp)) != NULL && pt->t_ms <= ms){
+         hz = pt->freq_hz;
+         load_play_next(lp);
+         s->play_points++;
+     }
+     if(hz >= 0) play_set_freq(s, (uint32_t)hz);
+     if(!pt){
+         if(load_play_done(lp)) s->play_done = true; // Main loop falls back to Stand by
+         else s->play_late++;                    // Both halves used up: SD behind the scheduler
+     }
+     s->play_pos_ms = ms;
+ }
+ 
+ static void play_stop(AppState* s){             // Scheduler off, file closed; PWM left to the caller
+     if(!s->play) return;
+     furi_timer_stop(s->play_timer);             // Before the buffer goes
+     s->pwm_running = s->play_pwm_on;            // PWM state back to the main loop
+     s->play_pwm_on = false;
+     s->freq_hz = s->play_hz;
+     load_play_close(s->play);
+     free(s->play);
+     s->play = NULL;
+     s->play_done = false;
+     furi_record_close(RECORD_STORAGE);          // Held while the file was open
+ }
+ 
  /* ---------- Mode application (Stand by / Low / Mid / Max) ---------- */
  static void apply_mode(AppState* s, uint8_t idx){
-     if(idx >= MODE_COUNT) return;                // Guard invalid indices
+     const Profile* p = active_profile(s);        // Modes, duty and 5V need of this inverter
+     if(idx >= p->mode_count) return;             // Guard invalid indices
+     play_stop(s);                                // Any mode choice ends a playback
+     runs_segment_end(s);                         // Previous speed's run time (RAM only)
      s->active = idx;                             // Remember which powered mode is active
  
-     const Mode* m = &kModes[idx];                // Pointer to chosen mode descriptor
- 
-     /* Minimal change: Samsung has its own frequencies; Embraco uses table as-is. */
-     uint32_t freq = m->freq_hz;                  // Start with table frequency
-     if(s->inverter == InvSamsung){               // Samsung overrides:                 // CHANGED
-         if(idx == 1)      freq = 5;              //  Low  = 5 Hz                       // CHANGED
-         else if(idx == 2) freq = 400;            //  Mid  = 400 Hz                     // CHANGED
-         else if(idx == 3) freq = 800;            //  Max  = 800 Hz                     // CHANGED
-         /* Stand by (idx == 0) remains 0 Hz */
-     }
+     const ProfileMode* m = &p->modes[idx];       // Pointer to chosen mode descriptor
+     uint32_t freq = m->freq_hz;                  // Frequency straight from the profile
+     s->freq_hz = freq;                           // Published for the plot sampler
  
      if(freq == 0){                               // Stand by: special no-PWM mode
          pwm_hw_stop_safe(&s->pwm_running);       // Ensure PWM is off
@@ -331,18 +660,109 @@
          s->remaining_ms = 0;                     // Reset countdown remaining
          s->timeout_expired = false;              // Clear timeout event flag
      } else {                                     // Any PWM-enabled mode
+         if(p->needs_5v && !otg_rail_good()){     // 5V dropped out since power on
+             pwm_hw_stop_safe(&s->pwm_running);   // Never drive PA7 into an unpowered board
+             pin_to_pp_low();                     // Known level until the main loop powers off
+             s->freq_hz = 0;                      // Nothing commanded
+             s->rail_lost = true;                 // Main loop switches to SAFE menu
+             return;
+         }
          pwm_hw_stop_safe(&s->pwm_running);       // Stop previous PWM (if any)
-         pwm_hw_start_safe(freq, &s->pwm_running);// Start new PWM at selected frequency
+         pwm_hw_start_safe(freq, p->duty_pct, &s->pwm_running); // Start new PWM at selected frequency
          start_tick_timer_if_needed(s);           // (Re)arm limit timers if configured
+         s->inrush_pending = (s->inrush != NULL); // Armed: main loop fires the burst capture
+         runs_segment_start(s, idx);              // Run hours count from here
+     }
+     led_apply(s, m->led_hz);                     // Update LED blink to reflect activity level
+     log_event(s, RunLogMode, (uint16_t)freq, m->label); // Timestamped in the session log
+ 
+     if(s->perf.input_cyc){                       // Triggered by a key: record input -> applied
+         s->perf.latency_us = perf_cyc_to_us(perf_cycles() - s->perf.input_cyc);
+     }
+ }
+ 
+ /* ---------- Accelerated hold-to-scroll ---------- */
+ /* Input service timing: Long fires ~300 ms after press, then Repeat every ~150 ms.
+  * Step grows with hold time so a 100-row list is crossed in < 1 s (1+2+8+24+64 = 99). */
+ typedef struct {
+     uint16_t held_ms;                           // Minimum hold duration for this step size
+     uint8_t  step;                              // Rows moved per Long/Repeat event
+ } NavAccelStep;
+ 
+ static const NavAccelStep kNavAccel[] = {
+     {  0,  1},                                  // Long (~300 ms): single row, same as a tap
+     {400,  2},                                  // 1st repeat (~450 ms)
+     {550,  8},                                  // 2nd repeat (~600 ms)
+     {700, 24},                                  // 3rd repeat (~750 ms)
+     {850, 64},                                  // 4th repeat onwards (~900 ms+)
+ };
+ #define NAV_ACCEL_COUNT (sizeof(kNavAccel)/sizeof(kNavAccel[0])) // Number of accel stages
+ 
+ typedef bool (*NavSelectableFn)(const void* ctx, uint8_t row); // Can the caret land on row?
+ 
+ /* Rows to move for this event: 1 for a tap, accelerated by hold time for Long/Repeat */
+ static uint8_t nav_step(const AppState* s, InputType type){
+     if(type != InputTypeLong && type != InputTypeRepeat) return 1; // Plain tap: one row
+     uint32_t held = furi_get_tick() - s->nav_press_tick;            // Ticks since key went down
+     uint8_t step = 1;                            // Fallback when held time is tiny
+     for(uint8_t i = 0; i < NAV_ACCEL_COUNT; i++){ // Pick the last stage we have reached
+         if(held >= furi_ms_to_ticks(kNavAccel[i].held_ms)) step = kNavAccel[i].step;
+     }
+     return step;
+ }
+ 
+ /* Move a windowed list cursor by dir*step rows.
+  * wrap=true (taps) wraps around the ends; wrap=false (held keys) stops at the ends so
+  * a large accelerated step never overshoots. Rows rejected by selectable() (headers)
+  * are skipped in the direction of travel, bouncing back at an end. */
+ static void nav_move(
+     uint8_t* cursor,                            // <> selected row
+     uint8_t* first_visible,                     // <> top row of the visible window
+     uint8_t row_total,                          // -> number of rows in the list
+     uint8_t window,                             // -> rows visible at once
+     int8_t dir,                                 // -> -1 = up, +1 = down
+     uint8_t step,                               // -> rows to move (>= 1)
+     bool wrap,                                  // -> wrap at ends instead of clamping
+     NavSelectableFn selectable,                 // -> row filter (NULL => every row)
+     const void* ctx){                           // -> context for selectable()
+     if(row_total == 0) return;                  // Nothing to navigate
+     int16_t last = (int16_t)(row_total - 1);    // Highest valid index
+     int16_t pos = (int16_t)(*cursor + dir * step); // Tentative new position
+ 
+     if(pos < 0)         pos = wrap ? last : 0;  // Past the top: wrap to bottom or stop
+     else if(pos > last) pos = wrap ? 0 : last;  // Past the bottom: wrap to top or stop
+ 
+     for(uint8_t guard = row_total;              // Skip non-selectable rows (bounded walk)
+         selectable && guard && !selectable(ctx, (uint8_t)pos); guard--){
+         pos = (int16_t)(pos + dir);             // -> keep going in the same direction
+         if(pos < 0 || pos > last){              // -> hit an end: turn around
+             dir = (int8_t)-dir;
+             pos = (int16_t)(pos + 2 * dir);
+             if(pos < 0 || pos > last){ pos = *cursor; break; } // -> nowhere to go: stay put
+         }
+     }
+ 
+     *cursor = (uint8_t)pos;                     // Commit selection
+     if(*cursor < *first_visible) *first_visible = *cursor; // Scroll window up
+     if(*cursor >= *first_visible + window){     // Scroll window down
+         *first_visible = (uint8_t)(*cursor - (window - 1));
      }
-     led_apply(s, m->led_blink_hz);               // Update LED blink to reflect activity level
  }
  
  /* ---------- Hint timer (short BACK overlay) ---------- */
  static void hint_timer_cb(void* ctx){            // Hides the hint after a short delay
      AppState* s = ctx;                           // Recover state
      s->hint_visible = false;                     // Turn off bottom hint ribbon
-     if(s->vp) view_port_update(s->vp);           // Redraw to remove it from the screen
+     ui_refresh(s);                               // Redraw to remove it from the screen
+ }
+ 
+ static void show_hint(AppState* s, const char* msg, uint32_t ms){ // Ribbon with auto-hide
+     s->hint_msg = msg;                          // -> text to show
+     s->hint_visible = true;                     // -> make ribbon visible
+     if(!s->hint_timer){                         // -> allocate one-shot timer once
+         s->hint_timer = furi_timer_alloc(hint_timer_cb, FuriTimerTypeOnce, s);
+     }
+     furi_timer_start(s->hint_timer, furi_ms_to_ticks(ms)); // -> start hide timer
  }
  
  /* ---------- Blocking alerts (confirmations) ---------- */
@@ -390,14 +810,14 @@
  
  /* ---------- Help layout math ---------- */
  static inline void help_layout_params(           // Compute visible help lines & max scroll
-     uint8_t total_lines,                         // -> number of lines in help text
+     uint16_t total_lines,                        // -> number of lines in help text
      uint8_t* out_max_lines,                      // <- how many lines fit on screen
-     uint8_t* out_max_top_line){                  // <- largest top-line index
+     uint16_t* out_max_top_line){                 // <- largest top-line index
      const uint8_t top = 10;                      // Top margin for help text
      const uint8_t line_h = 9;                    // Line height for FontSecondary
      uint8_t ml = (uint8_t)((CANVAS_H - top) / line_h); // Integer lines that fit
      if(ml < 1) ml = 1;                           // At least one line
-     uint8_t mtl = (total_lines > ml) ? (uint8_t)(total_lines - ml) : 0; // Max scroll offset
+     uint16_t mtl = (total_lines > ml) ? (uint16_t)(total_lines - ml) : 0; // Max scroll offset
      if(out_max_lines) *out_max_lines = ml;       // Return lines-on-screen
      if(out_max_top_line) *out_max_top_line = mtl;// Return max top-line index
  }
@@ -407,113 +827,101 @@
      canvas_set_font(c, FontPrimary);            // Big font
      canvas_set_color(c, ColorBlack);            // Black pixels on white background
  
-     const char* inv_name =                      // Choose inverter name for title
-         (s->inverter == InvEmbraco) ? "Embraco" : "Samsung";
+     const bool show_est =                       // Battery estimate only while powered
+         s->powered && s->runtime_est_s != TELEMETRY_RUNTIME_UNKNOWN;
+     const char* inv_name = active_profile(s)->name; // Profile name for title
      char title[32];                             // Small stack buffer for formatting title
-     snprintf(title, sizeof(title), "%s Starter", inv_name); // Compose "X Starter"
+     snprintf(title, sizeof(title), show_est ? "%s" : "%s Starter", inv_name); // Short form makes room
      canvas_draw_str(c, 4, TITLE_Y, title);      // Render at left padding x=4
  
-     if(s->remaining_ms > 0){                    // If a countdown is active, show “NNs” on the right
+     uint16_t right_x = (uint16_t)(SCROLLBAR_X - TIMER_MARGIN); // Right bound for right-hand items
+     if(s->remaining_ms > 0 || s->play){         // Countdown “NNs” (or "Play") on the right
          char tbuf[16];                          // Buffer for seconds string
          unsigned long sec =                     // Round up milliseconds to next second
              (unsigned long)((s->remaining_ms + 999)/1000);
-         snprintf(tbuf, sizeof(tbuf), "%lus", sec);      // Format as "NNs"
+         if(s->play) snprintf(tbuf, sizeof(tbuf), "Play"); // The file sets the speed
+         else snprintf(tbuf, sizeof(tbuf), "%lus", sec);   // Format as "NNs"
          uint16_t w = canvas_string_width(c, tbuf);      // Measure text width
-         uint16_t right_x = (uint16_t)(SCROLLBAR_X - TIMER_MARGIN); // Right bound
          uint16_t x = (w <= right_x) ? (uint16_t)(right_x - w) : 2; // Right align or clamp
          canvas_draw_str(c, x, TITLE_Y, tbuf);   // Draw the timer text
+         right_x = (x > 4) ? (uint16_t)(x - 4) : 0; // Estimate goes left of the countdown
      }
- }
- 
- /* ---------- Select Inverter screen ---------- */
- static void draw_select_inverter(Canvas* c, const AppState* s){
-     canvas_clear(c);                            // Clear full canvas
-     canvas_set_color(c, ColorBlack);            // Black drawing color
  
-     canvas_set_font(c, FontPrimary);            // Title font
-     canvas_draw_str(c, 4, TITLE_Y, "Inverter type"); // Draw title
- 
-     canvas_set_font(c, FontSecondary);          // Row font
-     int y = ROW_Y0;                             // Start at first row baseline
-     canvas_draw_str(c, 2, y, (s->cursor == 0) ? ">" : " "); // Caret for Embraco
-     canvas_draw_str(c, 14, y, "Embraco");       // Row text for Embraco
-     y += ROW_DY;                                // Move to second row baseline
-     canvas_draw_str(c, 2, y, (s->cursor == 1) ? ">" : " "); // Caret for Samsung
-     canvas_draw_str(c, 14, y, "Samsung");       // Row text for Samsung
- 
-     draw_scrollbar_dotted(c, 2, s->cursor);     // Scrollbar with 2 steps at current cursor
- 
-     if(s->hint_visible){                        // If hint should be shown…
-         const char* msg = "Long press back to exit"; // Footer message
-         uint16_t text_h = 10;                   // Footer height (approx)
-         uint16_t text_y = (uint16_t)(CANVAS_H - 2); // Baseline near bottom
-         canvas_set_color(c, ColorBlack);        // Switch to black for background
-         canvas_draw_box(c, 0, (uint16_t)(text_y - text_h), CANVAS_W, (uint16_t)(text_h + 4)); // Ribbon
-         canvas_set_color(c, ColorWhite);        // White text
-         canvas_draw_str(c, 14, text_y, msg);    // Draw footer text inset
-         canvas_set_color(c, ColorBlack);        // Restore black for future drawing
+     if(show_est){                               // "~1h05" / "~12m" battery runtime left
+         char ebuf[16];
+         unsigned long m = (unsigned long)(s->runtime_est_s / 60U);
+         if(m >= 60) snprintf(ebuf, sizeof(ebuf), "~%luh%02lu", m / 60, m % 60);
+         else        snprintf(ebuf, sizeof(ebuf), "~%lum", m);
+         canvas_set_font(c, FontSecondary);      // Smaller than the countdown
+         uint16_t w = canvas_string_width(c, ebuf);
+         if(w <= right_x) canvas_draw_str(c, (uint16_t)(right_x - w), TITLE_Y, ebuf);
+         canvas_set_font(c, FontPrimary);        // Restore for callers
      }
  }
  
- /* ---------- Main Menu screen (safe or powered) ---------- */
- static void draw_menu(Canvas* c, const AppState* s){
-     canvas_clear(c);                            // Clear the screen
-     draw_title(c, s);                           // Draw title and possible countdown
- 
-     canvas_set_font(c, FontSecondary);          // List font
-     const uint8_t MAX_ROWS = 4;                 // We always display up to 4 rows
+ /* ---------- Hint ribbon (shared by list screens) ---------- */
+ static void draw_hint_ribbon(Canvas* c, const char* msg){
+     uint16_t text_h = 10;                       // Footer height (approx)
+     uint16_t text_y = (uint16_t)(CANVAS_H - 2); // Baseline near bottom
+     canvas_set_color(c, ColorBlack);            // Switch to black for background
+     canvas_draw_box(c, 0, (uint16_t)(text_y - text_h), CANVAS_W, (uint16_t)(text_h + 4)); // Ribbon
+     canvas_set_color(c, ColorWhite);            // White text
+     canvas_draw_str(c, 14, text_y, msg);        // Draw footer text inset
+     canvas_set_color(c, ColorBlack);            // Restore black for future drawing
+ }
  
-     const bool powered = s->powered;            // Snapshot powered flag
-     uint8_t row_total = powered                 // Total number of rows depends on powered state
-         ? (uint8_t)(MODE_COUNT + 3)             // Powered: 0..3 modes, 4 off, 5 settings, 6 help
-         : 3;                                    // Safe: 0 on, 1 settings, 2 help
+ /* ---------- Help documents on SD ----------
+  * HELP_DIR/<profile name>.txt, else HELP_DIR/<family key>.txt, else the built-in text. The
+  * file stays open while the help screen is; the main loop reads the lines that came into
+  * view into the line cache and draw_help() only ever reads the cache. */
+ #define HELP_DIR EXT_PATH("apps_data/expert_tool_ics/help")
+ 
+ static void help_close(AppState* s){
+     HelpFile* hf = s->help_file;
+     if(!hf) return;
+     s->help_file = NULL;                        // draw_help() falls back to built-in from here
+     help_file_close(hf);
+     free(hf);
+     help_cache_reset(s->help_cache);            // A new HelpFile may reuse the address
+     furi_record_close(RECORD_STORAGE);
+ }
  
-     uint8_t first_visible = s->first_visible;   // Clamp top-of-window index
-     if(first_visible + MAX_ROWS > row_total){
-         first_visible = (row_total > MAX_ROWS) ? (uint8_t)(row_total - MAX_ROWS) : 0;
+ static void help_open(AppState* s){
+     help_close(s);
+     HelpFile* hf = malloc(sizeof(HelpFile));    // ~0.7 KB: offset window + read-ahead block
+     Storage* storage = furi_record_open(RECORD_STORAGE);
+     char path[HELP_FILE_PATH_LEN];
+     snprintf(path, sizeof(path), "%s/%s.txt", HELP_DIR, active_profile(s)->name);
+     bool ok = help_file_open(hf, storage, path);
+     if(!ok){                                    // No model-specific guide: try the family one
+         snprintf(path, sizeof(path), "%s/%s.txt", HELP_DIR, s->family->key);
+         ok = help_file_open(hf, storage, path);
      }
- 
-     for(uint8_t i = 0; i < MAX_ROWS; i++){      // Draw up to 4 rows
-         uint8_t row = (uint8_t)(first_visible + i); // Actual row index in the list
-         if(row >= row_total) break;             // Stop if out of range
-         int y = ROW_Y0 + i*ROW_DY;              // Compute baseline Y for this row
- 
-         if(row == s->cursor) canvas_draw_str(c, 2, y, ">");
-         else canvas_draw_str(c, 2, y, " ");     // Draw caret or space at left
- 
-         if(powered){                            // Powered menu contents
-             if(row < MODE_COUNT){               // One of the 4 modes
-                 canvas_draw_str(c, 14, y, kModes[row].name); // Draw mode name
-                 if(row == s->active){           // If this is the active mode, show checkmark
-                     int check_x = (int)SCROLLBAR_X - TIMER_MARGIN - 10; // Right area
-                     if(check_x < 90) check_x = 90; // Keep away from regular text
-                     draw_checkmark(c, check_x, y); // Paint check
-                 }
-             } else if(row == MODE_COUNT){       // Power off entry
-                 canvas_draw_str(c, 14, y, "Power off");
-             } else if(row == MODE_COUNT + 1){   // Settings
-                 canvas_draw_str(c, 14, y, "Settings");
-             } else {                            // Help
-                 canvas_draw_str(c, 14, y, "Help");
-             }
-         } else {                                // Safe (unpowered) menu contents
-             if(row == 0) canvas_draw_str(c, 14, y, "Power on");
-             else if(row == 1) canvas_draw_str(c, 14, y, "Settings");
-             else canvas_draw_str(c, 14, y, "Help");
-         }
+     if(ok && hf->count > 0){                    // Storage record stays open with the file
+         s->help_file_lines = hf->count;         // Before the pointer: the GUI thread reads both
+         s->help_file = hf;
+         return;
      }
+     if(ok) help_file_close(hf);                 // Empty file: built-in text instead
+     free(hf);
+     furi_record_close(RECORD_STORAGE);
+ }
  
-     draw_scrollbar_dotted(c, row_total, s->cursor); // Draw right-side scrollbar
+ static uint16_t help_count(const AppState* s, const void* file){ // Lines in the document on screen
+     return file ? s->help_file_lines : s->family->help->count;
+ }
  
-     if(s->hint_visible){                        // Optional bottom hint ribbon
-         const char* msg = "Long press back to exit";
-         uint16_t text_h = 10;
-         uint16_t text_y = (uint16_t)(CANVAS_H - 2);
-         canvas_set_color(c, ColorBlack);
-         canvas_draw_box(c, 0, (uint16_t)(text_y - text_h), CANVAS_W, (uint16_t)(text_h + 4));
-         canvas_set_color(c, ColorWhite);
-         canvas_draw_str(c, 14, text_y, msg);
-         canvas_set_color(c, ColorBlack);
+ static void help_prefetch(AppState* s){         // Visible SD lines -> cache (one read per block)
+     if(!s->help_file) return;
+     uint8_t max_lines;
+     help_layout_params(s->help_file->count, &max_lines, NULL);
+     char text[HELP_LINE_MAX];
+     for(uint8_t i = 0; i < max_lines; i++){
+         uint16_t idx = (uint16_t)(s->help_top_line + i);
+         if(idx >= s->help_file->count) break;
+         if(help_cache_find(s->help_cache, s->help_file, idx)) continue; // Scrolling: 1 new line
+         help_file_line(s->help_file, idx, text, sizeof(text));
+         help_cache_store(s->help_cache, s->help_file, idx, text);
      }
  }
  
@@ -523,21 +931,24 @@
      canvas_set_font(c, FontSecondary);          // Use smaller font for content
      canvas_set_color(c, ColorBlack);            // Draw in black
  
-     const char* const* LINES =                  // Choose which help text to show
-         (s->inverter == InvEmbraco) ? HELP_EMBRACO : HELP_SAMSUNG;
-     const uint8_t LINES_COUNT =                 // And how many lines it has
-         (s->inverter == InvEmbraco) ? HELP_EMBRACO_COUNT : HELP_SAMSUNG_COUNT;
+     const HelpDoc* doc = s->family->help;       // Built-in text unless an SD document is open
+     const void* file = s->help_file;            // Read once; only a cache key here, since
+     const uint16_t count = help_count(s, file); // help_close() may free it meanwhile
  
-     uint8_t max_lines, max_top_line;            // Compute visible capacity & max scroll
-     help_layout_params(LINES_COUNT, &max_lines, &max_top_line);
+     uint8_t max_lines;                          // Compute visible capacity & max scroll
+     uint16_t max_top_line;
+     help_layout_params(count, &max_lines, &max_top_line);
  
      const uint8_t top = 10;                     // Top margin where to start drawing text
      const uint8_t line_h = 9;                   // Line height for this font
  
      for(uint8_t i=0;i<max_lines;i++){           // Draw visible window of lines
-         uint8_t idx = (uint8_t)(s->help_top_line + i); // Line index to show
-         if(idx >= LINES_COUNT) break;           // Stop when out of content
-         canvas_draw_str(c, 2, (uint8_t)(top + i*line_h), LINES[idx]); // Draw line at computed Y
+         uint16_t idx = (uint16_t)(s->help_top_line + i); // Line index to show
+         if(idx >= count) break;                 // Stop when out of content
+         const char* line = file                 // SD: prefetched by the main loop
+             ? help_cache_find(s->help_cache, file, idx)
+             : help_cache_line(s->help_cache, doc, idx); // Built-in: decodes on a miss only
+         if(line) canvas_draw_str(c, 2, (uint8_t)(top + i*line_h), line); // Draw line at computed Y
      }
  
      uint16_t total_steps = (uint16_t)(max_top_line + 1); // Steps for scrollbar (top positions)
@@ -545,97 +956,1080 @@
      draw_scrollbar_dotted(c, total_steps, s->help_top_line); // Draw scrollbar based on scroll pos
  }
  
- /* ---------- Settings screen ---------- */
- static void draw_settings(Canvas* c, const AppState* s){
-     canvas_clear(c);                            // Clear screen
+ static void help_input(AppState* s, const InputEvent* ev, bool nav_ev){ // Help view scrolling
+     if(!nav_ev) return;                         // Only taps and holds matter here
+     const uint16_t total_lines = help_count(s, s->help_file); // Content length (SD or built-in)
+     uint8_t max_lines;                          // Calculate display capacity and max scroll
+     uint16_t max_top_line;
+     help_layout_params(total_lines, &max_lines, &max_top_line);
+     const uint8_t step = nav_step(s, ev->type); // Same hold acceleration as lists
+ 
+     if(ev->key == InputKeyUp){                  // Scroll up, stop at top
+         s->help_top_line = (s->help_top_line > step)
+             ? (uint16_t)(s->help_top_line - step) : 0;
+     } else if(ev->key == InputKeyDown){         // Scroll down, stop at end
+         s->help_top_line = (max_top_line - s->help_top_line > step)
+             ? (uint16_t)(s->help_top_line + step) : max_top_line;
+     } else if(ev->key == InputKeyBack && ev->type == InputTypeShort){ // BACK returns to menu
+         s->screen = ScreenMenu;
+         help_close(s);                          // Release the SD document
+         return;
+     }
+     help_prefetch(s);                           // Lines that scrolled into view
+ }
+ 
+ /* ---------- Display-dark run mode ---------- */
+ /* During a run with no key activity the backlight is switched off and redraws stop;
+  * the LED pattern from led_apply() is then the only status signal. Battery draw is
+  * sampled lit (just before going dark) and dark (averaged) for the Settings report. */
+ static const uint16_t kDarkAfterS[] = {0, 15, 30, 60, 120}; // 0 => feature off
+ #define DARK_AFTER_COUNT (sizeof(kDarkAfterS)/sizeof(kDarkAfterS[0]))
+ #define DARK_SAMPLE_MS 1000                     // Fuel-gauge sampling period while dark
+ 
+ static int16_t battery_draw_ma(void){           // Discharge current in mA (positive = draining)
+     float a = furi_hal_power_get_battery_current(FuriHalPowerICFuelGauge); // Amps, < 0 discharging
+     return (int16_t)(-a * 1000.0f);
+ }
+ 
+ static void dark_enter(AppState* s){            // Backlight off, freeze UI
+     s->lit_ma = battery_draw_ma();              // Reference reading with the display lit
+     s->dark_ma_sum = 0;
+     s->dark_ma_count = 0;
+     s->dark_sample_tick = furi_get_tick();
+     notification_message(s->notif, &sequence_display_backlight_off);
+     s->dark = true;                             // ui_refresh() now drops redraw requests
+ }
+ 
+ static void dark_exit(AppState* s){             // Any key: backlight on, redraw at once
+     if(s->dark_ma_count) s->dark_ma = (int16_t)(s->dark_ma_sum / s->dark_ma_count);
+     s->dark = false;
+     notification_message(s->notif, &sequence_display_backlight_on);
+     ui_refresh(s);                              // Catch up with state changed while dark
+ }
+ 
+ static void dark_poll(AppState* s){             // Main loop: enter dark / sample draw
+     uint32_t now = furi_get_tick();
+     if(s->dark){
+         if(now - s->dark_sample_tick >= furi_ms_to_ticks(DARK_SAMPLE_MS)){
+             s->dark_sample_tick = now;
+             s->dark_ma_sum += battery_draw_ma();
+             s->dark_ma_count++;
+         }
+         return;
+     }
+     uint16_t after = kDarkAfterS[s->dark_idx];  // Configured inactivity delay
+     if(after == 0 || !output_running(s)) return; // Only during a run with the feature enabled
+     if(now - s->last_input_tick >= furi_ms_to_ticks(after * 1000U)) dark_enter(s);
+ }
+ 
+ /* ---------- Analog input monitor ---------- */
+ /* Pin 3 (and optionally pin 7) are sampled continuously by DMA into a double buffer.
+  * Each half is reduced in the DMA interrupt by the SIMD kernel and folded into a
+  * window; the main loop publishes the window a few times per second. Nothing polls
+  * the ADC, so PWM changes in apply_mode() are watched without touching its timing. */
+ #define ANALOG_BLOCK      256                   // Samples per half buffer (~2.6 ms at AdcRateSlow)
+ #define ANALOG_PUBLISH_MS 250                   // Display window length
  
-     canvas_set_font(c, FontPrimary);            // Title font
+ typedef struct {
+     uint16_t min;                               // Smallest raw sample in the window
+     uint16_t max;                               // Largest raw sample in the window
+     uint32_t sum;                               // Sum of raw samples
+     uint32_t n;                                 // Samples in sum
+ } AnalogWin;
+ 
+ typedef struct AnalogMon {
+     AdcStream st;                               // ADC1 + DMA2 channel
+     uint16_t buf[2 * ANALOG_BLOCK] __attribute__((aligned(4))); // DMA double buffer
+     AnalogWin win[2];                           // Being accumulated by the ISR
+     AnalogWin pub[2];                           // Last published window (main loop)
+     volatile uint32_t kernel_cyc;               // Cycles spent in the last block reduction
+     uint32_t blocks_prev;                       // st.blocks at the last publish
+     uint16_t blocks_ps;                         // Published block rate
+ } AnalogMon;
+ 
+ static void analog_win_clear(AnalogWin* w){
+     w->min = UINT16_MAX;
+     w->max = 0;
+     w->sum = 0;
+     w->n = 0;
+ }
+ 
+ static void analog_win_add(AnalogWin* w, uint16_t mn, uint16_t mx, uint32_t sum, uint32_t n){
+     if(mn < w->min) w->min = mn;
+     if(mx > w->max) w->max = mx;
+     w->sum += sum;
+     w->n += n;
+ }
+ 
+ static void analog_block_cb(const uint16_t* block, size_t n, void* ctx){ // DMA IRQ
+     AnalogMon* m = ctx;
+     uint32_t t0 = perf_cycles();
+     DspLanes l;
+     dsp_lanes_u16(block, n / 2, &l);            // One pass, two lanes per instruction
+     if(m->st.cfg.channels == 1){                // Both lanes are the same pin: merge
+         uint16_t mn = (l.min[0] < l.min[1]) ? l.min[0] : l.min[1];
+         uint16_t mx = (l.max[0] > l.max[1]) ? l.max[0] : l.max[1];
+         analog_win_add(&m->win[0], mn, mx, l.sum[0] + l.sum[1], n);
+     } else {                                    // Lane = channel (interleaved sequence)
+         for(uint8_t ch = 0; ch < 2; ch++) analog_win_add(&m->win[ch], l.min[ch], l.max[ch], l.sum[ch], n / 2);
+     }
+     m->kernel_cyc = perf_cycles() - t0;
+ }
+ 
+ static void analog_stop(AppState* s){           // Release ADC1 and DMA
+     s->analog_mv = PLOT_NO_VALUE;               // Plot stops drawing the trace
+     if(!s->analog) return;
+     adc_stream_stop(&s->analog->st);
+     free(s->analog);
+     s->analog = NULL;
+ }
+ 
+ static void analog_start(AppState* s){          // (Re)start according to analog_cfg
+     analog_stop(s);
+     if(s->analog_cfg == 0 || s->adc_burst) return; // Off, or restarted when the burst ends
+     AnalogMon* m = malloc(sizeof(AnalogMon));   // ~1.1 KB: heap, not the 2 KB stack
+     for(uint8_t ch = 0; ch < 2; ch++){
+         analog_win_clear(&m->win[ch]);
+         analog_win_clear(&m->pub[ch]);
+     }
+     m->kernel_cyc = 0;
+     m->blocks_prev = 0;
+     m->blocks_ps = 0;
+     AdcStreamConfig cfg = {
+         .channels = s->analog_cfg,              // 1 or 2
+         .input = {AdcInputPin3, AdcInputPin7},
+         .rate = AdcRateSlow,                    // Supply/feedback lines: favour accuracy
+         .oversample = FuriHalAdcOversampleNone,
+         .circular = true,
+         .buf = m->buf,
+         .len = 2 * ANALOG_BLOCK,
+         .cb = analog_block_cb,
+         .ctx = m,
+     };
+     s->analog = m;
+     s->analog_pub_tick = furi_get_tick();
+     adc_stream_start(&m->st, &cfg);
+ }
+ 
+ static bool analog_poll(AppState* s){           // Main loop: publish the window when due
+     AnalogMon* m = s->analog;
+     uint32_t now = furi_get_tick();
+     if(!m || now - s->analog_pub_tick < furi_ms_to_ticks(ANALOG_PUBLISH_MS)) return false;
+ 
+     FURI_CRITICAL_ENTER();                      // Swap out the window the ISR writes
+     for(uint8_t ch = 0; ch < 2; ch++){
+         m->pub[ch] = m->win[ch];
+         analog_win_clear(&m->win[ch]);
+     }
+     uint32_t blocks = m->st.blocks;
+     FURI_CRITICAL_EXIT();
+ 
+     m->blocks_ps = (uint16_t)((blocks - m->blocks_prev) * 1000U / (now - s->analog_pub_tick));
+     m->blocks_prev = blocks;
+     s->analog_pub_tick = now;
+     if(m->pub[0].n) s->analog_mv = (int16_t)adc_stream_to_mv((uint16_t)(m->pub[0].sum / m->pub[0].n));
+     return true;
+ }
+ 
+ static void draw_analog(Canvas* c, const AppState* s){
+     const AnalogMon* m = s->analog;
+     canvas_clear(c);                            // Clear the display
      canvas_set_color(c, ColorBlack);            // Draw in black
-     canvas_draw_str(c, 4, TITLE_Y, "Settings"); // Title text
  
+     canvas_set_font(c, FontPrimary);            // Title
+     canvas_draw_str(c, 4, TITLE_Y, "Analog in");
      canvas_set_font(c, FontSecondary);          // Body font
  
-     const uint8_t MAX_ROWS = 4;                 // Visible rows at once
-     const uint8_t ROW_TOTAL = 5;                // Total rows including header
+     char buf[32];
+     if(!m){
+         canvas_draw_str(c, 2, ROW_Y0, "Off. OK: pin 3 / pins 3+7");
+         canvas_draw_str(c, 2, ROW_Y0 + ROW_DY, "0-2.5 V max, common GND");
+         return;
+     }
+     snprintf(buf, sizeof(buf), "%lukS/s", (unsigned long)(adc_stream_rate_hz(&m->st.cfg) / 1000U));
+     canvas_draw_str_aligned(c, SCROLLBAR_X - TIMER_MARGIN, TITLE_Y, AlignRight, AlignBottom, buf);
+ 
+     static const char* const kPinNames[] = {"P3", "P7"}; // Matches AdcInput order
+     for(uint8_t ch = 0; ch < m->st.cfg.channels; ch++){ // mV min/avg/max over the last window
+         const AnalogWin* w = &m->pub[ch];
+         if(w->n) snprintf(buf, sizeof(buf), "%s %u/%u/%umV", kPinNames[ch],
+             adc_stream_to_mv(w->min), adc_stream_to_mv((uint16_t)(w->sum / w->n)), adc_stream_to_mv(w->max));
+         else snprintf(buf, sizeof(buf), "%s -", kPinNames[ch]);
+         canvas_draw_str(c, 2, ROW_Y0 + ch * ROW_DY, buf);
+     }
+     snprintf(buf, sizeof(buf), "%u blk/s  kernel %luus", m->blocks_ps,
+         (unsigned long)perf_cyc_to_us(m->kernel_cyc));
+     canvas_draw_str(c, 2, ROW_Y0 + 2 * ROW_DY, buf);
+     snprintf(buf, sizeof(buf), "DMA err %lu  OK: inputs", (unsigned long)m->st.errors);
+     canvas_draw_str(c, 2, ROW_Y0 + 3 * ROW_DY, buf);
+ }
  
-     uint8_t first_visible = s->first_visible;   // Clamp window against total rows
-     if(first_visible + MAX_ROWS > ROW_TOTAL){
-         first_visible = (ROW_TOTAL > MAX_ROWS) ? (uint8_t)(ROW_TOTAL - MAX_ROWS) : 0;
+ static void analog_input(AppState* s, const InputEvent* ev, bool nav_ev){
+     UNUSED(nav_ev);
+     if(ev->type == InputTypeShort && ev->key == InputKeyOk){ // Off -> pin 3 -> pins 3+7 -> Off
+         s->analog_cfg = (uint8_t)((s->analog_cfg + 1) % 3);
+         analog_start(s);
+     } else if(ev->type == InputTypeShort && ev->key == InputKeyBack){ // BACK returns to menu
+         s->screen = ScreenMenu;                 // Sampling keeps running for the plot
      }
+ }
  
-     for(uint8_t i=0;i<MAX_ROWS;i++){            // Loop visible rows
-         uint8_t row = (uint8_t)(first_visible + i); // Actual row index
-         if(row >= ROW_TOTAL) break;             // Stop if past end
-         int y = ROW_Y0 + i*ROW_DY;              // Baseline Y for this row
+ /* ---------- Inrush burst capture ---------- */
+ /* While armed, every PWM start/retune fires a one-shot DMA capture of pin 3 (current
+  * clamp or shunt amplifier output). The ADC converts at full speed and its hardware
+  * oversampler averages 256 conversions per stored sample, so the first ~1 s fits a
+  * preallocated 8 KB buffer. The CPU only runs once, after the buffer is full. */
+ #define INRUSH_SAMPLES  4096                    // ~0.98 s at 4.17 kS/s
+ #define INRUSH_COLS     PLOT_W                  // Mini waveform columns
+ #define INRUSH_WAVE_H   22                      // Mini waveform height (pixels)
+ #define INRUSH_BAND_MIN 80                      // Settle band floor (raw counts, ~50 mV)
+ 
+ typedef struct Inrush {
+     AdcStream st;                               // One-shot ADC1 + DMA2 channel
+     uint16_t buf[INRUSH_SAMPLES] __attribute__((aligned(4))); // DMA target, allocated on arm
+     bool capturing;                             // DMA running
+     bool have_result;                           // Fields below are valid
+     uint16_t peak;                              // Highest sample (raw)
+     uint32_t peak_us;                           // Time of the peak after the trigger
+     uint16_t final;                             // Average of the last 1/8 of the window (raw)
+     uint32_t settle_us;                         // Time after which samples stay near `final`
+     uint16_t col_min[INRUSH_COLS];              // Mini waveform (raw)
+     uint16_t col_max[INRUSH_COLS];
+ } Inrush;
+ 
+ static void inrush_done_cb(const uint16_t* block, size_t n, void* ctx){ // DMA IRQ: nothing to do,
+     UNUSED(block); UNUSED(n); UNUSED(ctx);      // the main loop sees st.done
+ }
  
-         if(row == 2){                           // Row 2 is a non-selectable header
-             canvas_draw_str(c, 4, y, "Inverter type");
-             continue;                           // Skip caret and value rendering
-         }
+ static void inrush_fire(AppState* s){           // Main loop, right after apply_mode() started PWM
+     Inrush* r = s->inrush;
+     if(!r || r->capturing || s->scope || s->logic) return; // Disarmed, busy, or pin 3 is taken
+     analog_stop(s);                             // ADC1 is exclusive: pause the monitor
+     AdcStreamConfig cfg = {
+         .channels = 1,
+         .input = {AdcInputPin3, AdcInputPin3},
+         .rate = AdcRateFast,                    // 47.5 + 12.5 cycles: 1.07 MS/s raw
+         .oversample = FuriHalAdcOversample256,  // -> 4.17 kS/s of 256-conversion averages
+         .circular = false,                      // Fill once, then stop
+         .buf = r->buf,
+         .len = INRUSH_SAMPLES,
+         .cb = inrush_done_cb,
+         .ctx = r,
+     };
+     r->capturing = true;
+     s->adc_burst = true;
+     adc_stream_start(&r->st, &cfg);
+ }
  
-         canvas_draw_str(c, 2, y, (s->cursor == row) ? ">" : " "); // Caret for selectable rows
- 
-         if(row == 0){                           // Limit runtime toggle row
-             canvas_draw_str(c, 14, y, "Limit run time");
-             const char* val = s->limit_runtime ? "Yes" : "No"; // Value text
-             uint16_t w = canvas_string_width(c, val);          // Measure width for right align
-             uint16_t right_x = (uint16_t)(SCROLLBAR_X - TIMER_MARGIN); // Right bound
-             uint16_t x = (w <= right_x) ? (uint16_t)(right_x - w) : 2; // Right align/clamp
-             canvas_draw_str(c, x, y, val);     // Draw value
-         } else if(row == 1){                    // Arrow captcha toggle (placeholder)
-             canvas_draw_str(c, 14, y, "Arrow captcha");
-             const char* val = s->arrow_captcha ? "Yes" : "No";
-             uint16_t w = canvas_string_width(c, val);
-             uint16_t right_x = (uint16_t)(SCROLLBAR_X - TIMER_MARGIN);
-             uint16_t x = (w <= right_x) ? (uint16_t)(right_x - w) : 2;
-             canvas_draw_str(c, x, y, val);
-         } else if(row == 3){                    // Radio: Embraco
-             canvas_draw_str(c, 14, y, "Embraco");
-             if(s->inverter == InvEmbraco){      // Show check on selected inverter
-                 int check_x = (int)SCROLLBAR_X - TIMER_MARGIN - 10;
-                 if(check_x < 90) check_x = 90;
-                 draw_checkmark(c, check_x, y);
-             }
-         } else if(row == 4){                    // Radio: Samsung
-             canvas_draw_str(c, 14, y, "Samsung");
-             if(s->inverter == InvSamsung){
-                 int check_x = (int)SCROLLBAR_X - TIMER_MARGIN - 10;
-                 if(check_x < 90) check_x = 90;
-                 draw_checkmark(c, check_x, y);
-             }
+ static void inrush_analyse(Inrush* r){          // Peak, settle time and waveform, once per burst
+     const uint32_t rate = adc_stream_rate_hz(&r->st.cfg);
+     dsp_minmax_columns(r->buf, INRUSH_SAMPLES, INRUSH_COLS, r->col_min, r->col_max);
+ 
+     uint8_t pc = 0;                             // Peak column, then the sample inside it
+     for(uint8_t c = 1; c < INRUSH_COLS; c++) if(r->col_max[c] > r->col_max[pc]) pc = c;
+     const size_t per = INRUSH_SAMPLES / INRUSH_COLS;
+     size_t pi = pc * per;
+     while(r->buf[pi] != r->col_max[pc]) pi++;
+     r->peak = r->col_max[pc];
+     r->peak_us = (uint32_t)((uint64_t)pi * 1000000U / rate);
+ 
+     DspLanes l;                                 // Final level: mean of the last 1/8
+     dsp_lanes_u16(r->buf + INRUSH_SAMPLES * 7 / 8, INRUSH_SAMPLES / 16, &l);
+     r->final = (uint16_t)((l.sum[0] + l.sum[1]) / (INRUSH_SAMPLES / 8));
+ 
+     uint16_t band = (uint16_t)((r->peak - r->final) / 10); // ±10 % of the overshoot
+     if(band < INRUSH_BAND_MIN) band = INRUSH_BAND_MIN;
+     size_t i = INRUSH_SAMPLES;                  // Last sample outside the band, from the end
+     while(i > 0){
+         uint16_t v = r->buf[i - 1];
+         if(v > r->final + band || v + band < r->final) break;
+         i--;
+     }
+     r->settle_us = (uint32_t)((uint64_t)i * 1000000U / rate);
+     r->have_result = true;
+ }
+ 
+ static bool inrush_poll(AppState* s){           // Main loop: finish a completed burst
+     Inrush* r = s->inrush;
+     if(!r || !r->capturing || !r->st.done) return false;
+     adc_stream_stop(&r->st);
+     r->capturing = false;
+     s->adc_burst = false;
+     inrush_analyse(r);
+     analog_start(s);                            // Resume the monitor if it was on
+     return true;
+ }
+ 
+ static void inrush_arm(AppState* s, bool on){   // Allocate once on arm; free on disarm
+     if(on && !s->inrush){
+         s->inrush = malloc(sizeof(Inrush));
+         s->inrush->st.adc = NULL;               // adc_stream_stop() is a no-op until started
+         s->inrush->capturing = false;
+         s->inrush->have_result = false;
+     } else if(!on && s->inrush){
+         if(s->inrush->capturing){
+             adc_stream_stop(&s->inrush->st);
+             s->adc_burst = false;
+             analog_start(s);
          }
+         free(s->inrush);
+         s->inrush = NULL;
      }
+     s->inrush_pending = false;
+ }
+ 
+ static void draw_inrush(Canvas* c, const AppState* s){
+     const Inrush* r = s->inrush;
+     canvas_clear(c);                            // Clear the display
+     canvas_set_color(c, ColorBlack);            // Draw in black
+ 
+     canvas_set_font(c, FontPrimary);            // Title
+     canvas_draw_str(c, 4, TITLE_Y, "Inrush");
+     canvas_set_font(c, FontSecondary);          // Body font
+     canvas_draw_str_aligned(c, SCROLLBAR_X - TIMER_MARGIN, TITLE_Y, AlignRight, AlignBottom,
+         !r ? "OK: arm" : (r->capturing ? "Capturing" : "Armed"));
  
-     draw_scrollbar_dotted(c, ROW_TOTAL, s->cursor); // Right scrollbar
+     if(!r || !r->have_result){
+         canvas_draw_str(c, 2, ROW_Y0, r ? "Start or change speed" : "Pin 3: clamp / shunt amp");
+         return;
+     }
+     char buf[32];
+     snprintf(buf, sizeof(buf), "Peak %umV @%lums", adc_stream_to_mv(r->peak),
+         (unsigned long)(r->peak_us / 1000U));
+     canvas_draw_str(c, 2, ROW_Y0, buf);
+     snprintf(buf, sizeof(buf), "Settle %lums  end %umV", (unsigned long)(r->settle_us / 1000U),
+         adc_stream_to_mv(r->final));
+     canvas_draw_str(c, 2, ROW_Y0 + ROW_DY, buf);
+ 
+     const int32_t y1 = CANVAS_H - 1;            // Mini waveform, 0..peak full scale
+     const uint32_t top = r->peak ? r->peak : 1;
+     for(uint8_t x = 0; x < INRUSH_COLS; x++){   // One vertical min..max stroke per column
+         int32_t ya = y1 - (int32_t)((uint32_t)r->col_max[x] * (INRUSH_WAVE_H - 1) / top);
+         int32_t yb = y1 - (int32_t)((uint32_t)r->col_min[x] * (INRUSH_WAVE_H - 1) / top);
+         canvas_draw_line(c, x, ya, x, yb);
+     }
  }
  
- /* ---------- Draw dispatcher ---------- */
- static void draw_cb(Canvas* c, void* ctx){      // ViewPort draw callback
-     AppState* s = ctx;                          // Cast context back to AppState
-     switch(s->screen){                          // Dispatch based on current screen
-         case ScreenSelectInverter: draw_select_inverter(c, s); break;
-         case ScreenMenu:           draw_menu(c, s);            break;
-         case ScreenHelp:           draw_help(c, s);            break;
-         case ScreenSettings:       draw_settings(c, s);        break;
-         default:                   draw_menu(c, s);            break; // Fallback
+ static void inrush_input(AppState* s, const InputEvent* ev, bool nav_ev){
+     UNUSED(nav_ev);
+     if(ev->type == InputTypeShort && ev->key == InputKeyOk){ // Arm / disarm
+         inrush_arm(s, s->inrush == NULL);
+     } else if(ev->type == InputTypeShort && ev->key == InputKeyBack){ // BACK returns to menu
+         s->screen = ScreenMenu;                 // Stays armed for the next speed change
      }
  }
  
- /* ---------- Input queue plumbing ---------- */
- typedef struct { FuriMessageQueue* q; } InputCtx; // Wrapper to pass queue to callback
- static void vp_input_cb(InputEvent* e, void* ctx){ // ViewPort input callback (ISR-ish context)
-     InputCtx* ic = ctx;                         // Recover wrapper
-     InputEvent ev = *e;                         // Copy event (avoid pointer lifetime issues)
-     furi_message_queue_put(ic->q, &ev, 0);      // Push event to queue (non-blocking)
+ /* ---------- Oscilloscope screen ---------- */
+ /* Pin 3 streams into a circular DMA double buffer. When the GUI has taken the last
+  * frame, the DMA interrupt searches the half that just filled for a rising edge and
+  * decimates the 512 samples after it straight into 128 min/max columns: no sample is
+  * ever copied. Columns are double-buffered between the ISR (back) and draw (front);
+  * a 33 ms timer redraws only when a new frame is waiting. */
+ #define SCOPE_BLOCK     1024                    // Samples per DMA half
+ #define SCOPE_WINDOW    (SCOPE_BLOCK / 2)       // Samples shown; the trigger is searched before it
+ #define SCOPE_COLS      CANVAS_W                // One column per pixel, 4 samples each
+ #define SCOPE_TOP       16                      // Trace area: below the status line
+ #define SCOPE_H         (CANVAS_H - SCOPE_TOP)
+ #define SCOPE_HYST      40                      // Trigger hysteresis (raw counts, ~25 mV)
+ #define SCOPE_LEVEL_STEP 128                    // UP/DOWN trigger step (raw, ~78 mV)
+ #define SCOPE_AUTO_MS   100                     // Free-run if no edge for this long
+ #define SCOPE_FRAME_MS  33                      // Redraw poll: up to 30 frames/s
+ #define SCOPE_BARRIER() __atomic_signal_fence(__ATOMIC_SEQ_CST) // Orders the handover (one core)
+ 
+ static const struct {
+     AdcRate rate;                               // Per-conversion sampling time
+     FuriHalAdcOversample oversample;            // Hardware averaging for slow timebases
+ } kScopeTimebase[] = {                          // Window = 512 samples
+     {AdcRateMax,  FuriHalAdcOversampleNone},    // 200 µs
+     {AdcRateFast, FuriHalAdcOversampleNone},    // 480 µs
+     {AdcRateMid,  FuriHalAdcOversampleNone},    // 2.1 ms
+     {AdcRateSlow, FuriHalAdcOversampleNone},    // 5.2 ms
+     {AdcRateSlow, FuriHalAdcOversample8},       // 42 ms
+     {AdcRateSlow, FuriHalAdcOversample64},      // 334 ms
+ };
+ #define SCOPE_TB_COUNT (sizeof(kScopeTimebase)/sizeof(kScopeTimebase[0]))
+ 
+ typedef struct Scope {
+     AdcStream st;                               // Circular ADC1 + DMA2 channel
+     uint16_t buf[2 * SCOPE_BLOCK] __attribute__((aligned(4))); // DMA double buffer (4 KB)
+     uint16_t col_min[2][SCOPE_COLS];            // [front/back] decimated columns
+     uint16_t col_max[2][SCOPE_COLS];
+     bool col_trig[2];                           // Frame was triggered (vs. free-run)
+     volatile uint8_t front;                     // Column set the draw callback reads
+     volatile bool frame_ready;                  // Back set filled, waiting for the GUI
+     volatile bool hold;                         // Freeze the display
+     uint16_t level;                             // Trigger level (raw)
+     uint32_t auto_blocks;                       // Blocks without an edge before free-running
+     uint32_t miss;                              // Blocks since the last frame
+     uint8_t tb;                                 // Timebase index
+     FuriTimer* timer;                           // Frame poll
+     uint32_t frames;                            // Frames drawn this second
+     uint32_t fps_tick;                          // Start of the fps window
+     uint16_t fps;                               // Published frames per second
+ } Scope;
+ 
+ static void scope_block_cb(const uint16_t* block, size_t n, void* ctx){ // DMA IRQ
+     Scope* sc = ctx;
+     if(sc->frame_ready || sc->hold) return;     // GUI still has the last frame
+     size_t t = dsp_find_rising(block, n - SCOPE_WINDOW, sc->level, SCOPE_HYST);
+     bool trig = t < n - SCOPE_WINDOW;
+     if(!trig){
+         if(++sc->miss < sc->auto_blocks) return; // Keep waiting for an edge
+         t = 0;                                   // Auto: show the block untriggered
+     }
+     sc->miss = 0;
+     uint8_t back = sc->front ^ 1;
+     dsp_minmax_columns(block + (t & ~(size_t)1), SCOPE_WINDOW, SCOPE_COLS, // In place, even start
+         sc->col_min[back], sc->col_max[back]);
+     sc->col_trig[back] = trig;
+     SCOPE_BARRIER();
+     sc->frame_ready = true;                     // Publish after the columns are written
+ }
+ 
+ static void scope_timer_cb(void* ctx){          // Timer thread: redraw only for new frames
+     AppState* s = ctx;
+     if(s->scope->frame_ready) ui_refresh(s);
+ }
+ 
+ static void scope_restart(Scope* sc){           // Apply the current timebase
+     adc_stream_stop(&sc->st);
+     AdcStreamConfig cfg = {
+         .channels = 1,
+         .input = {AdcInputPin3, AdcInputPin3},
+         .rate = kScopeTimebase[sc->tb].rate,
+         .oversample = kScopeTimebase[sc->tb].oversample,
+         .circular = true,
+         .buf = sc->buf,
+         .len = 2 * SCOPE_BLOCK,
+         .cb = scope_block_cb,
+         .ctx = sc,
+     };
+     sc->auto_blocks = (uint32_t)((uint64_t)adc_stream_rate_hz(&cfg) * SCOPE_AUTO_MS / 1000U / SCOPE_BLOCK);
+     if(sc->auto_blocks == 0) sc->auto_blocks = 1;
+     sc->miss = 0;
+     sc->frame_ready = false;
+     adc_stream_start(&sc->st, &cfg);
+ }
+ 
+ static void scope_open(AppState* s){
+     analog_stop(s);                             // ADC1 is exclusive: pause the monitor
+     Scope* sc = malloc(sizeof(Scope));          // ~5 KB
+     sc->st.adc = NULL;                          // Not started yet
+     for(uint8_t c = 0; c < SCOPE_COLS; c++){ sc->col_min[0][c] = 0; sc->col_max[0][c] = 0; }
+     sc->col_trig[0] = false;
+     sc->front = 0;
+     sc->hold = false;
+     sc->level = 2048;                           // Mid-scale (~1.25 V)
+     sc->tb = 3;                                 // 5 ms: mains-frequency signals
+     sc->frames = 0;
+     sc->fps_tick = furi_get_tick();
+     sc->fps = 0;
+     s->scope = sc;
+     scope_restart(sc);
+     sc->timer = furi_timer_alloc(scope_timer_cb, FuriTimerTypePeriodic, s);
+     furi_timer_start(sc->timer, furi_ms_to_ticks(SCOPE_FRAME_MS));
+ }
+ 
+ static void scope_close(AppState* s){
+     Scope* sc = s->scope;
+     if(!sc) return;
+     furi_timer_stop(sc->timer);                 // No more callbacks touching sc
+     furi_timer_free(sc->timer);
+     adc_stream_stop(&sc->st);
+     s->scope = NULL;
+     free(sc);
+     analog_start(s);                            // Resume the monitor if it was on
+ }
+ 
+ static void draw_scope(Canvas* c, const AppState* s){
+     Scope* sc = s->scope;
+     if(sc->frame_ready){                        // Take the new frame (ISR now owns the old one)
+         sc->front ^= 1;
+         SCOPE_BARRIER();                        // Swap lands before the ISR may write again
+         sc->frame_ready = false;
+         sc->frames++;
+     }
+     uint32_t now = furi_get_tick();
+     if(now - sc->fps_tick >= furi_ms_to_ticks(1000)){
+         sc->fps = (uint16_t)sc->frames;
+         sc->frames = 0;
+         sc->fps_tick = now;
+     }
+ 
+     canvas_clear(c);                            // Clear the display
+     canvas_set_color(c, ColorBlack);            // Draw in black
+     canvas_set_font(c, FontSecondary);          // Status line
+ 
+     char buf[32];
+     uint32_t win_us = (uint32_t)((uint64_t)SCOPE_WINDOW * 1000000U / adc_stream_rate_hz(&sc->st.cfg));
+     if(win_us < 1000U) snprintf(buf, sizeof(buf), "%luus", (unsigned long)win_us);
+     else snprintf(buf, sizeof(buf), "%lums", (unsigned long)((win_us + 500U) / 1000U));
+     canvas_draw_str(c, 0, 8, buf);
+     snprintf(buf, sizeof(buf), "T%umV", adc_stream_to_mv(sc->level));
+     canvas_draw_str_aligned(c, CANVAS_W / 2, 8, AlignCenter, AlignBottom, buf);
+     snprintf(buf, sizeof(buf), "%s %u", sc->hold ? "HOLD" : (sc->col_trig[sc->front] ? "TRIG" : "AUTO"), sc->fps);
+     canvas_draw_str_aligned(c, CANVAS_W - 1, 8, AlignRight, AlignBottom, buf);
+ 
+     const int32_t y1 = CANVAS_H - 1;            // 0 V at the bottom, 2.5 V at the top
+     const uint16_t* mn = sc->col_min[sc->front];
+     const uint16_t* mx = sc->col_max[sc->front];
+     for(uint8_t x = 0; x < SCOPE_COLS; x++){    // Read the decimated columns in place
+         int32_t ya = y1 - (int32_t)((uint32_t)mx[x] * (SCOPE_H - 1) / 4095U);
+         int32_t yb = y1 - (int32_t)((uint32_t)mn[x] * (SCOPE_H - 1) / 4095U);
+         canvas_draw_line(c, x, ya, x, yb);
+     }
+     int32_t yt = y1 - (int32_t)((uint32_t)sc->level * (SCOPE_H - 1) / 4095U);
+     for(uint8_t x = 0; x < CANVAS_W; x += 4) canvas_draw_dot(c, x, yt); // Dotted trigger level
+ }
+ 
+ static void scope_input(AppState* s, const InputEvent* ev, bool nav_ev){
+     Scope* sc = s->scope;
+     if(ev->type == InputTypeShort && ev->key == InputKeyBack){ // BACK returns to menu
+         scope_close(s);
+         s->screen = ScreenMenu;                 // Keep caret where it was
+         return;
+     }
+     if(ev->type == InputTypeShort && ev->key == InputKeyOk){ // Run / hold
+         sc->hold = !sc->hold;
+     } else if(ev->type == InputTypeShort && (ev->key == InputKeyLeft || ev->key == InputKeyRight)){
+         if(ev->key == InputKeyRight && sc->tb + 1 < (int)SCOPE_TB_COUNT) sc->tb++; // Slower
+         else if(ev->key == InputKeyLeft && sc->tb > 0) sc->tb--;                   // Faster
+         else return;
+         scope_restart(sc);
+     } else if(nav_ev && (ev->key == InputKeyUp || ev->key == InputKeyDown)){ // Trigger level
+         if(ev->key == InputKeyUp) sc->level = (sc->level + SCOPE_LEVEL_STEP > 4095) ? 4095 : sc->level + SCOPE_LEVEL_STEP;
+         else sc->level = (sc->level > SCOPE_LEVEL_STEP) ? sc->level - SCOPE_LEVEL_STEP : 0;
+     }
+ }
+ 
+ /* ---------- Logic analyzer screen ---------- */
+ /* Captures pins 2 (our PWM), 3 and 4 as digital levels, e.g. the Samsung board's
+  * communication lines, and saves them as VCD for PulseView/GTKWave on a PC. */
+ #define LOGIC_DIR EXT_PATH("apps_data/expert_tool_ics")
+ 
+ static const uint32_t kLogicRateHz[] = {1000000, 250000, 100000, 10000}; // Snapshot rates
+ #define LOGIC_RATE_COUNT (sizeof(kLogicRateHz)/sizeof(kLogicRateHz[0]))
+ 
+ static void logic_open(AppState* s){
+     analog_stop(s);                             // Pin 3 becomes a digital input
+     s->logic = malloc(sizeof(LogicCapture));    // ~18 KB: DMA halves + run buffer
+     s->logic->running = false;
+     s->logic->n_runs = 0;
+     s->logic->samples = 0;
+     s->logic->full = false;
+ }
+ 
+ static void logic_close(AppState* s){
+     if(!s->logic) return;
+     logic_capture_stop(s->logic);
+     free(s->logic);
+     s->logic = NULL;
+     analog_start(s);                            // Resume the monitor if it was on
+ }
+ 
+ static bool logic_poll(AppState* s){            // Main loop: progress + auto-stop when full
+     LogicCapture* lc = s->logic;
+     if(!lc || !lc->running) return false;
+     if(lc->full) logic_capture_stop(lc);        // ISR already halted the DMA
+     return true;                                // Redraw progress while capturing
+ }
+ 
+ static void logic_save(AppState* s){            // Next free la_NNN.vcd on the SD card
+     Storage* storage = furi_record_open(RECORD_STORAGE);
+     storage_simply_mkdir(storage, EXT_PATH("apps_data"));
+     storage_simply_mkdir(storage, LOGIC_DIR);
+     static char path[64];                       // Also shown in the hint ribbon
+     bool ok = false;
+     for(uint16_t i = 0; i < 1000; i++){
+         snprintf(path, sizeof(path), LOGIC_DIR "/la_%03u.vcd", i);
+         if(storage_common_stat(storage, path, NULL) == FSE_OK) continue; // Taken
+         ok = logic_capture_save_vcd(s->logic, storage, path);
+         break;
+     }
+     furi_record_close(RECORD_STORAGE);
+     show_hint(s, ok ? path + sizeof(LOGIC_DIR) : "SD write failed", 2500); // File name only
+ }
+ 
+ static void draw_logic(Canvas* c, const AppState* s){
+     const LogicCapture* lc = s->logic;
+     canvas_clear(c);                            // Clear the display
+     canvas_set_color(c, ColorBlack);            // Draw in black
+ 
+     canvas_set_font(c, FontPrimary);            // Title
+     canvas_draw_str(c, 4, TITLE_Y, "Logic");
+     canvas_set_font(c, FontSecondary);          // Body font
+     char buf[32];
+     uint32_t rate = kLogicRateHz[s->logic_rate_idx];
+     if(rate >= 1000000U) snprintf(buf, sizeof(buf), "%luMHz", (unsigned long)(rate / 1000000U));
+     else snprintf(buf, sizeof(buf), "%lukHz", (unsigned long)(rate / 1000U));
+     canvas_draw_str_aligned(c, SCROLLBAR_X - TIMER_MARGIN, TITLE_Y, AlignRight, AlignBottom, buf);
+ 
+     canvas_draw_str(c, 2, ROW_Y0, "Pins 2(A7) 3(A6) 4(A4)");
+     uint32_t ms = (uint32_t)((uint64_t)lc->samples * 1000U / rate);
+     snprintf(buf, sizeof(buf), "%s %lu.%03lus",
+         lc->running ? "Capturing" : (lc->full ? "Full" : (lc->n_runs ? "Stopped" : "Ready")),
+         (unsigned long)(ms / 1000U), (unsigned long)(ms % 1000U));
+     canvas_draw_str(c, 2, ROW_Y0 + ROW_DY, buf);
+     snprintf(buf, sizeof(buf), "Runs %u/%u  x%lu", lc->n_runs, LOGIC_RUNS, // Compression vs raw
+         (unsigned long)(lc->n_runs ? lc->samples / lc->n_runs : 0));
+     canvas_draw_str(c, 2, ROW_Y0 + 2 * ROW_DY, buf);
+     canvas_draw_str(c, 2, ROW_Y0 + 3 * ROW_DY,
+         lc->running ? "OK: stop" : (lc->n_runs ? "OK: new  DOWN: save" : "OK: start  </>: rate"));
+ }
+ 
+ static void logic_input(AppState* s, const InputEvent* ev, bool nav_ev){
+     UNUSED(nav_ev);
+     LogicCapture* lc = s->logic;
+     if(ev->type != InputTypeShort) return;
+     if(ev->key == InputKeyBack){                // BACK returns to menu
+         logic_close(s);
+         s->screen = ScreenMenu;                 // Keep caret where it was
+     } else if(ev->key == InputKeyOk){           // Start / stop
+         if(lc->running) logic_capture_stop(lc);
+         else logic_capture_start(lc, kLogicRateHz[s->logic_rate_idx]);
+     } else if(lc->running){
+         return;                                 // Rate and save only while idle
+     } else if(ev->key == InputKeyDown && lc->n_runs){
+         logic_save(s);
+     } else if(ev->key == InputKeyRight && s->logic_rate_idx + 1 < (int)LOGIC_RATE_COUNT){
+         s->logic_rate_idx++;                    // Slower: longer capture
+     } else if(ev->key == InputKeyLeft && s->logic_rate_idx > 0){
+         s->logic_rate_idx--;                    // Faster: finer timing
+     }
+ }
+ 
+ /* ---------- Temperature probe (1-Wire, pin 17) ---------- */
+ /* A DS18B20 on the 1-Wire header pin (17, with 3V3 on pin 9 and GND on 18). The main
+  * loop calls ds18b20_poll() every tick: a conversion is started, and its result is
+  * collected on a tick >= 750 ms later, so no call waits for the sensor. */
+ #define TEMP_STALE_MS 3000                      // Older readings are not plotted
+ 
+ static void ow_set(void* ctx, bool release){ UNUSED(ctx); furi_hal_gpio_write(&gpio_ibutton, release); }
+ static bool ow_get(void* ctx){ UNUSED(ctx); return furi_hal_gpio_read(&gpio_ibutton); }
+ static void ow_delay_us(void* ctx, uint32_t us){ UNUSED(ctx); furi_hal_cortex_delay_us(us); }
+ static void ow_lock(void* ctx, bool on){        // Interrupts off for one slot (<= 70 µs)
+     static __FuriCriticalInfo crit;             // Slots never nest
+     UNUSED(ctx);
+     if(on) crit = __furi_critical_enter();
+     else __furi_critical_exit(crit);
+ }
+ 
+ static const OneWireHal kOneWireHal = {
+     .set = ow_set, .get = ow_get, .delay_us = ow_delay_us, .lock = ow_lock, .ctx = NULL,
+ };
+ 
+ static void temp_enable(AppState* s, bool on){  // Claim / release pin 17
+     s->temp_probe = on;
+     s->temp_dc = PLOT_NO_VALUE;
+     ds18b20_init(&s->ds, &kOneWireHal);
+     if(on){
+         furi_hal_gpio_write(&gpio_ibutton, true); // Released (high) before switching to output
+         furi_hal_gpio_init(&gpio_ibutton, GpioModeOutputOpenDrain, GpioPullNo, GpioSpeedLow);
+     } else {
+         furi_hal_gpio_init(&gpio_ibutton, GpioModeAnalog, GpioPullNo, GpioSpeedLow); // Hi-Z
+     }
+ }
+ 
+ static bool temp_poll(AppState* s){             // Main loop: start / collect conversions
+     if(!s->temp_probe) return false;
+     uint32_t now = furi_get_tick();
+     bool got = ds18b20_poll(&s->ds, now);
+     if(got) s->temp_dc = s->ds.temp_dc;         // Published for the plot sampler
+     else if(s->temp_dc != PLOT_NO_VALUE && now - s->ds.t_sample_ms > furi_ms_to_ticks(TEMP_STALE_MS)){
+         s->temp_dc = PLOT_NO_VALUE;             // Probe unplugged: stop plotting old data
+         got = true;
+     }
+     return got;
+ }
+ 
+ /* ---------- Live plot screen ---------- */
+ #define PLOT_PERIOD_MS 500                      // Sample period: 128 columns ≈ 64 s window
+ 
+ static void plot_timer_cb(void* ctx){           // Periodic sampler (timer thread)
+     AppState* s = ctx;                          // Recover state
+ 
+     uint32_t now = perf_cycles();               // Timer jitter: actual vs nominal period
+     if(s->perf.timer_prev_cyc){
+         uint32_t dt = now - s->perf.timer_prev_cyc;
+         uint32_t nominal = PLOT_PERIOD_MS * 1000U * furi_hal_cortex_instructions_per_microsecond();
+         uint32_t err = (dt > nominal) ? (dt - nominal) : (nominal - dt);
+         if(err > s->perf.jitter_cyc_max) s->perf.jitter_cyc_max = err;
+     }
+     s->perf.timer_prev_cyc = now;
+     int16_t mv = s->analog_mv;                  // Pin 3 voltage as the measured trace, if sampled
+     plot_set_scale(s->plot,                     // No-op unless inverter or analog state changed
+         (uint16_t)profile_freq_max(active_profile(s)), 0, (mv == PLOT_NO_VALUE) ? 0 : 2500);
+     plot_push(s->plot, furi_get_tick(),         // Append commanded frequency (+ pin 3 mV, probe °C)
+         (uint16_t)(output_running(s) ? s->freq_hz : 0), mv, s->temp_dc);
+     if(s->screen == ScreenPlot) ui_refresh(s);  // Redraw only when visible
+ }
+ 
+ static void draw_plot(Canvas* c, const AppState* s){
+     canvas_clear(c);                            // Clear the display
+     canvas_set_color(c, ColorBlack);            // Draw in black
+     canvas_set_font(c, FontSecondary);          // Small header font
+ 
+     char buf[24];                               // Header: current commanded frequency
+     const PlotSample* last = plot_latest(s->plot);
+     if(last && last->temp_dc != PLOT_NO_VALUE){ // Probe temperature next to the frequency
+         char temp[10];                          // "-3276.8C" at worst
+         snprintf(buf, sizeof(buf), "%u Hz %s", (unsigned)last->freq_hz,
+             temp_str(temp, sizeof(temp), last->temp_dc));
+     } else {
+         snprintf(buf, sizeof(buf), "%u Hz", last ? (unsigned)last->freq_hz : 0U);
+     }
+     canvas_draw_str(c, 2, 9, buf);
+ 
+     if(s->remaining_ms > 0){                    // Countdown on the right, as in the title
+         snprintf(buf, sizeof(buf), "%lus", (unsigned long)((s->remaining_ms + 999) / 1000));
+         canvas_draw_str_aligned(c, CANVAS_W - 2, 9, AlignRight, AlignBottom, buf);
+     }
+     snprintf(buf, sizeof(buf), "max %u", (unsigned)s->plot->freq_max); // Full-scale label
+     canvas_draw_str_aligned(c, CANVAS_W / 2, 9, AlignCenter, AlignBottom, buf);
+ 
+     plot_draw(s->plot, c, CANVAS_H - PLOT_H);   // Single bitmap blit for the chart
+ }
+ 
+ static void plot_input(AppState* s, const InputEvent* ev, bool nav_ev){
+     UNUSED(nav_ev);
+     if(ev->type == InputTypeShort && ev->key == InputKeyBack){ // BACK returns to menu
+         s->screen = ScreenMenu;                 // Keep caret where it was
+     }
+ }
+ 
+ /* ---------- Battery telemetry screen ---------- */
+ static const uint8_t kTelemetryPeriodS[] = {1, 2, 5, 10}; // Selectable sampling periods
+ #define TELEMETRY_PERIOD_COUNT (sizeof(kTelemetryPeriodS)/sizeof(kTelemetryPeriodS[0]))
+ 
+ static void draw_battery(Canvas* c, const AppState* s){
+     const Telemetry* t = s->telemetry;
+     canvas_clear(c);                            // Clear the display
+     canvas_set_color(c, ColorBlack);            // Draw in black
+ 
+     canvas_set_font(c, FontPrimary);            // Title
+     canvas_draw_str(c, 4, TITLE_Y, "Battery");
+     const TelemetrySample* last = telemetry_latest(t);
+     canvas_set_font(c, FontSecondary);          // Body font
+     char otg[20];                               // OTG state + last measured settle time
+     if(last && last->otg && s->otg_settle_ms) snprintf(otg, sizeof(otg), "OTG %lums", (unsigned long)s->otg_settle_ms);
+     else snprintf(otg, sizeof(otg), (last && last->otg) ? "OTG on" : "OTG off");
+     canvas_draw_str_aligned(c, SCROLLBAR_X - TIMER_MARGIN, TITLE_Y, AlignRight, AlignBottom, otg);
+ 
+     if(!last){                                  // Nothing sampled yet
+         canvas_draw_str(c, 4, ROW_Y0, "Sampling...");
+         return;
+     }
+ 
+     char buf[32];
+     char temp[10];                              // "-3276.8C" at worst
+     snprintf(buf, sizeof(buf), "Now %u.%02uV %dmA %s",    // Latest reading
+         last->batt_mv / 1000U, (last->batt_mv % 1000U) / 10U, last->batt_ma,
+         temp_str(temp, sizeof(temp), last->temp_dc));
+     canvas_draw_str(c, 2, ROW_Y0, buf);
+ 
+     snprintf(buf, sizeof(buf), "mA %ld/%ld/%ld",               // Session min/avg/max
+         (long)t->ma.min, (long)telemetry_stat_avg(&t->ma), (long)t->ma.max);
+     canvas_draw_str(c, 2, ROW_Y0 + ROW_DY, buf);
+     snprintf(buf, sizeof(buf), "mV %ld/%ld/%ld",
+         (long)t->mv.min, (long)telemetry_stat_avg(&t->mv), (long)t->mv.max);
+     canvas_draw_str(c, 2, ROW_Y0 + 2 * ROW_DY, buf);
+     snprintf(buf, sizeof(buf), "C %ld/%ld/%ld  n=%lu",
+         (long)(t->temp.min / 10), (long)(telemetry_stat_avg(&t->temp) / 10), (long)(t->temp.max / 10),
+         (unsigned long)t->ma.n);
+     canvas_draw_str(c, 2, ROW_Y0 + 3 * ROW_DY, buf);
+ }
+ 
+ static void battery_input(AppState* s, const InputEvent* ev, bool nav_ev){
+     UNUSED(nav_ev);
+     if(ev->type == InputTypeShort && ev->key == InputKeyBack){ // BACK returns to menu
+         s->screen = ScreenMenu;                 // Keep caret where it was
+     }
+ }
+ 
+ /* ---------- Fault-code reader screen ---------- */
+ /* The inverter status output (through an optocoupler/open collector) goes to header
+  * pin 5 (PB3). Edges are timestamped by TIM2 input capture and decoded here while the
+  * screen is open; PA7 output is not touched, so a run can continue while reading. */
+ typedef struct FaultReader {
+     FaultCapture cap;                           // ISR-filled edge ring
+     FaultDecoder dec;                           // Pattern state machine
+ } FaultReader;
+ 
+ static void fault_open(AppState* s){            // Claim the pin and start decoding
+     s->fault = malloc(sizeof(FaultReader));     // ~0.6 KB ring: keep it off the stack
+     fault_decoder_init(&s->fault->dec, &s->family->fault);
+     fault_capture_start(&s->fault->cap);
+     fault_decoder_edge(&s->fault->dec,          // Seed the idle level
+         fault_capture_now_us(), fault_capture_level());
+ }
+ 
+ static void fault_close(AppState* s){           // Release TIM2 and return the pin to Hi-Z
+     if(!s->fault) return;
+     fault_capture_stop(&s->fault->cap);
+     free(s->fault);
+     s->fault = NULL;
+ }
+ 
+ static bool fault_poll(AppState* s){            // Main loop: drain edges into the decoder
+     FaultReader* f = s->fault;
+     bool changed = false;
+     FaultEdge e;
+     while(fault_capture_pop(&f->cap, &e)){      // Timestamps come from hardware, not from here
+         fault_decoder_edge(&f->dec, e.t_us, e.level);
+         changed = true;
+     }
+     if(fault_decoder_idle(&f->dec, fault_capture_now_us())) changed = true; // Trailing pause
+     return changed;
+ }
+ 
+ static void draw_fault(Canvas* c, const AppState* s){
+     const FaultDecoder* d = &s->fault->dec;
+     canvas_clear(c);                            // Clear the display
+     canvas_set_color(c, ColorBlack);            // Draw in black
+ 
+     canvas_set_font(c, FontPrimary);            // Title
+     canvas_draw_str(c, 4, TITLE_Y, "Fault code");
+     canvas_set_font(c, FontSecondary);          // Body font
+     canvas_draw_str_aligned(c, SCROLLBAR_X - TIMER_MARGIN, TITLE_Y, AlignRight, AlignBottom, "in: pin 5");
+ 
+     char buf[32];
+     snprintf(buf, sizeof(buf), "%s  LED %s", d->p->name, fault_decoder_lit(d) ? "on" : "off");
+     canvas_draw_str(c, 2, ROW_Y0, buf);
+ 
+     if(d->p->long_on_us) snprintf(buf, sizeof(buf), "Blinks %u long + %u", d->tens, d->units);
+     else snprintf(buf, sizeof(buf), "Blinks %u", d->units);
+     canvas_draw_str(c, 2, ROW_Y0 + ROW_DY, buf);
+ 
+     if(d->last_code == FAULT_CODE_NONE) snprintf(buf, sizeof(buf), "Last -");
+     else snprintf(buf, sizeof(buf), "Last %u x%u", d->last_code, d->repeat);
+     canvas_draw_str(c, 2, ROW_Y0 + 2 * ROW_DY, buf);
+     snprintf(buf, sizeof(buf), "err %u drop %lu", d->errors, (unsigned long)s->fault->cap.dropped);
+     canvas_draw_str_aligned(c, SCROLLBAR_X - TIMER_MARGIN, ROW_Y0 + 2 * ROW_DY, AlignRight, AlignBottom, buf);
+ 
+     canvas_set_font(c, FontPrimary);            // The answer stands out
+     if(d->confirmed == FAULT_CODE_NONE) snprintf(buf, sizeof(buf), "Code: waiting");
+     else snprintf(buf, sizeof(buf), "Code: %u", d->confirmed);
+     canvas_draw_str(c, 2, ROW_Y0 + 3 * ROW_DY, buf);
+ }
+ 
+ static void fault_input(AppState* s, const InputEvent* ev, bool nav_ev){
+     UNUSED(nav_ev);
+     if(ev->type == InputTypeShort && ev->key == InputKeyOk){ // OK clears the decoded codes
+         fault_decoder_init(&s->fault->dec, &s->family->fault);
+         fault_decoder_edge(&s->fault->dec, fault_capture_now_us(), fault_capture_level());
+     } else if(ev->type == InputTypeShort && ev->key == InputKeyBack){ // BACK returns to menu
+         fault_close(s);                         // Stop capturing
+         s->screen = ScreenMenu;                 // Keep caret where it was
+     }
+ }
+ 
+ /* ---------- Battery runtime guard ---------- */
+ /* Stop before the Flipper browns out with PA7 in an undefined state: if the battery
+  * cannot cover the rest of a timed run (or is into its reserve on an unlimited run),
+  * drop to Stand by, which drives PA7 LOW. */
+ static void runtime_guard(AppState* s){         // Main loop, after each telemetry sample
+     const TelemetrySample* last = telemetry_latest(s->telemetry);
+     s->runtime_est_s = last ? telemetry_runtime_s(s->telemetry, last->otg) : TELEMETRY_RUNTIME_UNKNOWN;
+     if(!output_running(s) || s->runtime_est_s == TELEMETRY_RUNTIME_UNKNOWN) return;
+ 
+     bool short_of_time = (s->remaining_ms > 0)  // Timed run: can we finish it?
+         ? ((uint64_t)s->runtime_est_s * 1000U < s->remaining_ms)
+         : (s->runtime_est_s == 0);              // Unlimited run: stop at the reserve
+     if(!short_of_time) return;
+ 
+     log_event(s, RunLogError, 0, "low battery");
+     apply_mode(s, 0);                           // Stand by: PWM off, PA7 LOW, timers cleared
+     show_hint(s, "Low battery: Stand by", 4000);
+     if(s->dark) dark_exit(s);                   // Make the stop visible
+ }
+ 
+ /* ---------- Persistent settings (internal flash) ---------- */
+ /* Toggles only mark the RAM copy dirty. The main loop writes it once the settings have
+  * been left alone for SETTINGS_QUIET_MS, and on exit if still dirty, so a burst of
+  * toggles costs one flash write and the input path never waits on storage. */
+ #define SETTINGS_PATH     INT_PATH(".expert_tool_ics.settings")
+ #define SETTINGS_MAGIC    0x1C
+ #define SETTINGS_VERSION  2                    // 2: + serial
+ #define SETTINGS_QUIET_MS 5000
+ 
+ typedef struct {
+     char    profile[PROFILE_NAME_LEN];          // By name: SD pack order can change
+     uint8_t limit_runtime;
+     uint8_t arrow_captcha;
+     uint8_t dark_idx;                           // Index into kDarkAfterS
+     uint8_t telem_idx;                          // Index into kTelemetryPeriodS
+     uint8_t perf_hud;
+     char    serial[RUN_SERIAL_LEN];             // Compressor under test
+ } SavedSettings;
+ 
+ static void settings_touch(AppState* s){        // Called by every settings action
+     s->settings_dirty = true;
+     s->settings_tick = furi_get_tick();         // Quiet period restarts
+ }
+ 
+ static void settings_load(AppState* s){         // Before the first screen; one small read
+     SavedSettings st;
+     if(!saved_struct_load(SETTINGS_PATH, &st, sizeof(st), SETTINGS_MAGIC, SETTINGS_VERSION)){
+         return;                                 // First launch / old format: defaults stand
+     }
+     s->limit_runtime = st.limit_runtime;
+     s->arrow_captcha = st.arrow_captcha;
+     s->perf_hud = st.perf_hud;
+     if(st.dark_idx < DARK_AFTER_COUNT) s->dark_idx = st.dark_idx;
+     if(st.telem_idx < TELEMETRY_PERIOD_COUNT) s->telem_idx = st.telem_idx;
+     st.profile[sizeof(st.profile) - 1] = '\0';
+     st.serial[sizeof(st.serial) - 1] = '\0';
+     memcpy(s->serial, st.serial, sizeof(s->serial));
+     for(uint8_t i = 0; i < profile_total(s); i++){ // Missing SD file: keep the default
+         const char* name = profile_at(s, i)->name;
+         if(strcmp(name, st.profile) == 0){ select_profile(s, i); return; }
+     }
+     int32_t model = model_db_find(st.profile);  // Ladders picked by model code carry its name
+     if(model >= 0) select_model(s, (uint16_t)model);
+ }
+ 
+ static void settings_flush(AppState* s){        // Write now if anything changed
+     if(!s->settings_dirty) return;
+     SavedSettings st = {
+         .limit_runtime = s->limit_runtime,
+         .arrow_captcha = s->arrow_captcha,
+         .dark_idx = s->dark_idx,
+         .telem_idx = s->telem_idx,
+         .perf_hud = s->perf_hud,
+     };
+     snprintf(st.profile, sizeof(st.profile), "%s", active_profile(s)->name);
+     memcpy(st.serial, s->serial, sizeof(st.serial));
+     saved_struct_save(SETTINGS_PATH, &st, sizeof(st), SETTINGS_MAGIC, SETTINGS_VERSION);
+     s->settings_dirty = false;                  // A failed write is not retried in a loop
+ }
+ 
+ static void settings_poll(AppState* s){         // Main loop: flush after the quiet period
+     if(s->settings_dirty && furi_get_tick() - s->settings_tick >= furi_ms_to_ticks(SETTINGS_QUIET_MS)){
+         settings_flush(s);
+     }
+ }
+ 
+ /* ---------- Run hours screen ---------- */
+ /* Serial entry without a keyboard: OK starts editing, LEFT/RIGHT move the caret,
+  * UP/DOWN cycle the character under it (blank = end of the serial), OK/BACK finish.
+  * The model lookup screen types label codes the same way. */
+ static const char kSerialChars[] = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-";
+ #define SERIAL_CHAR_COUNT (sizeof(kSerialChars) - 1)
+ 
+ static void runs_lookup(AppState* s){           // Snapshot binary search + index slot
+     s->unit_found = s->runs && s->serial[0] &&
+                     run_db_lookup(s->runs, run_db_hash(s->serial), &s->unit);
+ }
+ 
+ static void runs_poll(AppState* s){             // Main loop: card writes only while unpowered
+     if(!s->powered && s->runs && s->runs->n_pending) run_db_service(s->runs);
+ }
+ 
+ static void draw_run_hours(Canvas* c, const AppState* s){
+     canvas_clear(c);                            // Clear the display
+     canvas_set_color(c, ColorBlack);            // Draw in black
+ 
+     canvas_set_font(c, FontPrimary);            // Title
+     canvas_draw_str(c, 4, TITLE_Y, "Run hours");
+     canvas_set_font(c, FontSecondary);          // Body font
+ 
+     char buf[32];
+     snprintf(buf, sizeof(buf), "S/N %s", s->serial[0] ? s->serial : (s->serial_edit ? "" : "-"));
+     canvas_draw_str(c, 2, ROW_Y0, buf);
+     if(s->serial_edit){                         // Caret under the edited character
+         char pre[RUN_SERIAL_LEN + 4];           // Text left of the caret
+         snprintf(pre, sizeof(pre), "S/N %.*s", s->serial_pos, s->serial);
+         uint16_t x = (uint16_t)(2 + canvas_string_width(c, pre));
+         canvas_draw_line(c, x, ROW_Y0 + 1, x + 4, ROW_Y0 + 1);
+         canvas_draw_str_aligned(c, SCROLLBAR_X - TIMER_MARGIN, TITLE_Y, AlignRight, AlignBottom, "Editing");
+         return;
+     }
+     canvas_draw_str_aligned(c, SCROLLBAR_X - TIMER_MARGIN, TITLE_Y, AlignRight, AlignBottom, "OK: S/N");
+     if(!s->serial[0]){
+         canvas_draw_str(c, 2, ROW_Y0 + ROW_DY, "Set a serial to track runs");
+         return;
+     }
+     if(!s->unit_found){
+         canvas_draw_str(c, 2, ROW_Y0 + ROW_DY, "No runs recorded yet");
+         return;
+     }
+ 
+     uint32_t total = 0;
+     for(uint8_t m = 0; m < RUN_DB_MODES; m++) total += s->unit.secs[m];
+     snprintf(buf, sizeof(buf), "Total %luh%02lu  %lu runs", (unsigned long)(total / 3600U),
+         (unsigned long)(total / 60U % 60U), (unsigned long)s->unit.runs);
+     canvas_draw_str(c, 2, ROW_Y0 + ROW_DY, buf);
+ 
+     const Profile* p = active_profile(s);       // Speed labels of the selected inverter
+     uint8_t shown = 0;
+     for(uint8_t m = 1; m < RUN_DB_MODES && shown < 4; m++){ // Two speeds per row
+         uint32_t secs = s->unit.secs[m];
+         if(secs == 0) continue;
+         char label[8];
+         if(m < p->mode_count) snprintf(label, sizeof(label), "%.5s", p->modes[m].label);
+         else snprintf(label, sizeof(label), "Mode%u", m);
+         snprintf(buf, sizeof(buf), "%s %luh%02lu", label, (unsigned long)(secs / 3600U),
+             (unsigned long)(secs / 60U % 60U));
+         canvas_draw_str(c, (shown & 1) ? 66 : 2, ROW_Y0 + (2 + shown / 2) * ROW_DY, buf);
+         shown++;
+     }
+ }
+ 
+ static void code_cycle(char* text, size_t cap, uint8_t pos, int8_t dir){ // UP/DOWN on the caret
+     size_t len = strlen(text);
+     if(pos == len && len + 1 >= cap) return;    // Full
+     const char* at = strchr(kSerialChars, (pos < len) ? text[pos] : ' ');
+     uint8_t i = at ? (uint8_t)(at - kSerialChars) : 0;
+     i = (uint8_t)((i + SERIAL_CHAR_COUNT + dir) % SERIAL_CHAR_COUNT);
+     if(kSerialChars[i] == ' '){                 // Blank ends the text here
+         text[pos] = '\0';
+     } else {
+         text[pos] = kSerialChars[i];
+         if(pos == len) text[pos + 1] = '\0';    // Appended one character
+     }
+ }
+ 
+ static void run_hours_input(AppState* s, const InputEvent* ev, bool nav_ev){
+     if(!s->serial_edit){
+         if(ev->type == InputTypeShort && ev->key == InputKeyOk){ // Start editing at the end
+             s->serial_edit = true;
+             s->serial_pos = (uint8_t)strlen(s->serial);
+         } else if(ev->type == InputTypeShort && ev->key == InputKeyBack){ // BACK returns to menu
+             s->screen = ScreenMenu;
+         }
+         return;
+     }
+     size_t len = strlen(s->serial);
+     if(ev->type == InputTypeShort && (ev->key == InputKeyOk || ev->key == InputKeyBack)){
+         s->serial_edit = false;                 // Done: remember and look it up
+         uint8_t mode = s->seg_mode;             // Open segment (mode or playback), if any
+         runs_segment_end(s);                    // A running segment belongs to the old serial
+         if(mode) runs_segment_start(s, mode);
+         settings_touch(s);
+         runs_lookup(s);
+     } else if(nav_ev && ev->key == InputKeyUp){
+         code_cycle(s->serial, sizeof(s->serial), s->serial_pos, 1);
+     } else if(nav_ev && ev->key == InputKeyDown){
+         code_cycle(s->serial, sizeof(s->serial), s->serial_pos, -1);
+     } else if(ev->type == InputTypeShort && ev->key == InputKeyLeft){
+         if(s->serial_pos > 0) s->serial_pos--;
+     } else if(ev->type == InputTypeShort && ev->key == InputKeyRight){
+         if(s->serial_pos < len) s->serial_pos++;
+     }
+     if(s->serial_pos > strlen(s->serial)) s->serial_pos = (uint8_t)strlen(s->serial); // After a blank
  }
  
  /* ---------- State transitions for power ---------- */
  static void enter_safe_menu(AppState* s){       // Switch to SAFE menu (unpowered state)
+     play_stop(s);                               // Output is cut below
+     runs_segment_end(s);                        // Close the running speed's segment
+     if(s->powered) log_event(s, RunLogPowerOff, 0, NULL); // Only real transitions are logged
      s->powered = false;                         // Mark as unpowered
      s->cursor = 0;                              // Reset selection to first row
      s->first_visible = 0;                       // Reset window offset to top
  
      pwm_hw_stop_safe(&s->pwm_running);          // Ensure PWM is stopped
+     s->freq_hz = 0;                             // Nothing commanded
      pin_to_hiz();                               // Disconnect PA7 (no driving)
      power_5v_set(false);                        // Force OTG 5V OFF universally
      led_apply(s, 0);                            // Turn LED off (no blinking)
@@ -644,12 +2038,725 @@
      s->timeout_expired = false;                 // Clear timeout flag
  }
  
- static void enter_powered_menu_standby(AppState* s){ // Switch to POWERED menu, Stand by mode
+ static bool enter_powered_menu_standby(AppState* s){ // Switch to POWERED menu, Stand by mode
+     if(!inverter_power_5v_wait(active_profile(s), &s->otg_settle_ms)){ // 5V (if needed) must come up first
+         log_event(s, RunLogError, 0, "5V rail failed to start");
+         enter_safe_menu(s);                     // Clean failure: everything off
+         show_hint(s, "5V rail failed to start", 3000);
+         return false;
+     }
+     if(!s->powered){                            // New test session:
+         telemetry_reset_stats(s->telemetry);    // -> fresh min/avg/max
+         log_event(s, RunLogPowerOn, 0, active_profile(s)->name); // -> which inverter
+     }
      s->powered = true;                          // Mark as powered
      s->cursor = 0;                              // Place caret on "Stand by"
      s->first_visible = 0;                       // Reset window
-     inverter_power_5v(s->inverter, true);       // Enable 5V only for Samsung (no-op otherwise)
      apply_mode(s, 0);                           // Apply Stand by: output LOW, no timers, LED off
+     return true;
+ }
+ 
+ static void open_screen(AppState* s, ScreenId screen){ // Switch screen with caret on first row
+     s->screen = screen;                         // New screen
+     s->cursor = 0;                              // Reset selection
+     s->first_visible = 0;                       // Reset window
+ }
+ 
+ /* ---------- Model lookup screen ---------- */
+ /* Type the start of the label code; every change is one prefix search over the packed
+  * key table (model_db.h). OK loads the first match's speed ladder as the active profile. */
+ #define MODEL_ROWS 3                            // Matches listed under the query
+ 
+ static void draw_model(Canvas* c, const AppState* s){
+     canvas_clear(c);                            // Clear the display
+     canvas_set_color(c, ColorBlack);            // Draw in black
+ 
+     canvas_set_font(c, FontPrimary);            // Title
+     canvas_draw_str(c, 4, TITLE_Y, "Model lookup");
+     canvas_set_font(c, FontSecondary);          // Body font
+ 
+     uint16_t count;
+     uint16_t first = model_db_prefix(s->model_query, &count);
+     char buf[32];
+     snprintf(buf, sizeof(buf), "%u found", count);
+     canvas_draw_str_aligned(c, SCROLLBAR_X - TIMER_MARGIN, TITLE_Y, AlignRight, AlignBottom, buf);
+ 
+     snprintf(buf, sizeof(buf), "Code %s", s->model_query);
+     canvas_draw_str(c, 2, ROW_Y0, buf);
+     char pre[MODEL_CODE_LEN + 6];               // Text left of the caret
+     snprintf(pre, sizeof(pre), "Code %.*s", s->model_pos, s->model_query);
+     uint16_t x = (uint16_t)(2 + canvas_string_width(c, pre));
+     canvas_draw_line(c, x, ROW_Y0 + 1, x + 4, ROW_Y0 + 1);
+ 
+     if(count == 0){
+         canvas_draw_str(c, 2, ROW_Y0 + ROW_DY, "No model starts like that");
+         return;
+     }
+     for(uint8_t r = 0; r < MODEL_ROWS && r < count; r++){
+         const CompressorModel* m = model_db_get((uint16_t)(first + r));
+         uint8_t y = (uint8_t)(ROW_Y0 + (1 + r) * ROW_DY);
+         if(r == 0) canvas_draw_str(c, 2, y, ">"); // OK takes this one
+         canvas_draw_str(c, 8, y, model_db_code((uint16_t)(first + r)));
+         if(m->rpm_per_hz) snprintf(buf, sizeof(buf), "%u-%u", m->rpm_min, m->rpm_max);
+         else snprintf(buf, sizeof(buf), "%s", inverter_family_get(m->family)->profile.name);
+         canvas_draw_str_aligned(c, SCROLLBAR_X - TIMER_MARGIN, y, AlignRight, AlignBottom, buf);
+     }
+ }
+ 
+ static void model_input(AppState* s, const InputEvent* ev, bool nav_ev){
+     size_t len = strlen(s->model_query);
+     if(ev->type == InputTypeShort && ev->key == InputKeyOk){
+         uint16_t count;
+         uint16_t first = model_db_prefix(s->model_query, &count);
+         if(count == 0) return;                  // Nothing to load
+         select_model(s, first);
+         settings_touch(s);                      // Remembered by model code
+         enter_safe_menu(s);                     // Same as changing the inverter type
+         s->screen = ScreenMenu;
+         static char msg[32];                    // Ribbon text must outlive this call
+         const Profile* p = active_profile(s);
+         snprintf(msg, sizeof(msg), "%s: %u-%u Hz", model_db_code(first),
+             p->modes[1].freq_hz, p->modes[p->mode_count - 1].freq_hz);
+         show_hint(s, msg, 2500);
+     } else if(ev->type == InputTypeShort && ev->key == InputKeyBack){ // BACK returns to menu
+         s->screen = ScreenMenu;
+     } else if(nav_ev && ev->key == InputKeyUp){
+         code_cycle(s->model_query, sizeof(s->model_query), s->model_pos, 1);
+     } else if(nav_ev && ev->key == InputKeyDown){
+         code_cycle(s->model_query, sizeof(s->model_query), s->model_pos, -1);
+     } else if(ev->type == InputTypeShort && ev->key == InputKeyLeft){
+         if(s->model_pos > 0) s->model_pos--;
+     } else if(ev->type == InputTypeShort && ev->key == InputKeyRight){
+         if(s->model_pos < len) s->model_pos++;
+     }
+     if(s->model_pos > strlen(s->model_query)) s->model_pos = (uint8_t)strlen(s->model_query);
+ }
+ 
+ /* ---------- Load-profile playback screen ---------- */
+ /* UP/DOWN pick a file in PLAY_DIR, LEFT/RIGHT the time scale, OK starts / stops. BACK
+  * leaves the screen with the file still playing; any mode or Power off ends it. */
+ static void play_scan(AppState* s){             // Count the files, name the selected one
+     s->play_files = 0;
+     s->play_name[0] = '\0';
+     Storage* storage = furi_record_open(RECORD_STORAGE);
+     File* d = storage_file_alloc(storage);
+     if(storage_dir_open(d, PLAY_DIR)){
+         FileInfo fi;
+         char name[sizeof(s->play_name)];
+         while(storage_dir_read(d, &fi, name, sizeof(name))){
+             if((fi.flags & FSF_DIRECTORY) || name[0] == '.') continue; // Also skips "._x" files
+             if(s->play_files == s->play_file) snprintf(s->play_name, sizeof(s->play_name), "%s", name);
+             s->play_files++;
+         }
+     }
+     storage_dir_close(d);
+     storage_file_free(d);
+     furi_record_close(RECORD_STORAGE);
+     if(s->play_files && !s->play_name[0]){      // Files were removed: back to the first
+         s->play_file = 0;
+         play_scan(s);
+     }
+ }
+ 
+ static void play_start(AppState* s){
+     if(!s->play_name[0]) return;
+     if(s->limit_runtime){                       // A replay outlasts any per-mode timeout
+         show_hint(s, "Turn off Limit run time", 2000);
+         return;
+     }
+     apply_mode(s, 0);                           // Stand by first: timers and run segment closed
+     char path[128];
+     snprintf(path, sizeof(path), PLAY_DIR "/%s", s->play_name);
+     s->play = malloc(sizeof(LoadPlay));         // ~1.3 KB however long the file is
+     if(!s->play){
+         show_hint(s, "Out of memory", 2000);
+         return;
+     }
+     Storage* storage = furi_record_open(RECORD_STORAGE); // Held until play_stop()
+     if(!load_play_open(s->play, storage, path, (uint16_t)profile_freq_max(active_profile(s)))){
+         free(s->play);
+         s->play = NULL;
+         furi_record_close(RECORD_STORAGE);
+         show_hint(s, "No speed points in file", 2000);
+         return;
+     }
+     s->play_points = 0;
+     s->play_late = 0;
+     s->play_pos_ms = 0;
+     s->play_done = false;
+     s->play_hz = 0;                             // Stand by above: PWM off, pin LOW
+     s->play_pwm_on = s->pwm_running;
+     s->play_seq = 0;
+     s->play_seq_seen = 0;
+     log_event(s, RunLogMode, 0, "Playback");
+     const Profile* p = active_profile(s);
+     led_apply(s, (p->mode_count > 1) ? p->modes[1].led_hz : 0); // Running: lowest speed's blink
+ 
+     s->play_t0 = furi_get_tick();
+     play_timer_cb(s);                           // t = 0 now; the timer is not running yet
+     if(!s->play_timer) s->play_timer = furi_timer_alloc(play_timer_cb, FuriTimerTypePeriodic, s);
+     furi_timer_start(s->play_timer, furi_ms_to_ticks(PLAY_TICK_MS));
+ }
+ 
+ static uint8_t play_mode_row(const Profile* p, uint32_t hz){ // Run-hours row nearest to hz
+     uint8_t best = 1;
+     uint32_t best_d = UINT32_MAX;
+     for(uint8_t i = 1; i < p->mode_count; i++){ // Row 0 is Stand by
+         uint32_t f = p->modes[i].freq_hz;
+         uint32_t d = (f > hz) ? f - hz : hz - f;
+         if(d < best_d){ best = i; best_d = d; }
+     }
+     return best;
+ }
+ 
+ static bool play_poll(AppState* s){             // Main loop: rail, state mirror, refill, end
+     if(!s->play) return false;
+     if(active_profile(s)->needs_5v && !otg_rail_good()){ // Same guard as apply_mode()
+         play_stop(s);                           // Scheduler off: PWM is ours again
+         pwm_hw_stop_safe(&s->pwm_running);      // Never drive PA7 into an unpowered board
+         pin_to_pp_low();
+         s->freq_hz = 0;
+         s->rail_lost = true;                    // Main loop switches to SAFE menu
+         return true;
+     }
+     s->freq_hz = s->play_hz;                    // Published for the plot sampler
+     uint16_t seq = s->play_seq;
+     if(seq != s->play_seq_seen){                // Speed changed since the last poll
+         s->play_seq_seen = seq;
+         runs_segment_end(s);                    // Run hours per speed, as for a mode change
+         if(s->freq_hz) runs_segment_start(s, play_mode_row(active_profile(s), s->freq_hz));
+         log_event(s, RunLogMode, (uint16_t)s->freq_hz, "Playback");
+         if(s->freq_hz && s->inrush) s->inrush_pending = true; // Armed: burst on the change
+     }
+     if(s->play_done){
+         apply_mode(s, 0);                       // Ends the playback, output LOW
+         show_hint(s, "Playback finished", 2500);
+         return true;
+     }
+     load_play_fill(s->play);                    // Halves the scheduler has used up
+     return true;                                // Redraw position while playing
+ }
+ 
+ static void draw_playback(Canvas* c, const AppState* s){
+     const LoadPlay* lp = s->play;
+     canvas_clear(c);                            // Clear the display
+     canvas_set_color(c, ColorBlack);            // Draw in black
+ 
+     canvas_set_font(c, FontPrimary);            // Title
+     canvas_draw_str(c, 4, TITLE_Y, "Playback");
+     canvas_set_font(c, FontSecondary);          // Body font
+     char buf[40];
+     snprintf(buf, sizeof(buf), "x%u", kPlayScale[s->play_scale_idx]);
+     canvas_draw_str_aligned(c, SCROLLBAR_X - TIMER_MARGIN, TITLE_Y, AlignRight, AlignBottom, buf);
+ 
+     if(!s->play_files){
+         canvas_draw_str(c, 2, ROW_Y0, "No files in");
+         canvas_draw_str(c, 2, ROW_Y0 + ROW_DY, "apps_data/expert_tool_ics/");
+         canvas_draw_str(c, 2, ROW_Y0 + 2 * ROW_DY, "playback");
+         return;
+     }
+     snprintf(buf, sizeof(buf), "%.24s", s->play_name);
+     canvas_draw_str(c, 2, ROW_Y0, buf);
+     if(lp){
+         uint32_t sec = s->play_pos_ms / 1000U;
+         snprintf(buf, sizeof(buf), "%02lu:%02lu:%02lu  %lu Hz", (unsigned long)(sec / 3600U),
+             (unsigned long)(sec / 60U % 60U), (unsigned long)(sec % 60U), (unsigned long)s->freq_hz);
+         canvas_draw_str(c, 2, ROW_Y0 + ROW_DY, buf);
+         snprintf(buf, sizeof(buf), "Points %lu  late %lu", (unsigned long)s->play_points,
+             (unsigned long)s->play_late);
+         canvas_draw_str(c, 2, ROW_Y0 + 2 * ROW_DY, buf);
+         if(lp->skipped || lp->clamped){         // Lines ignored / speeds capped so far
+             snprintf(buf, sizeof(buf), "Skip %u cap %u  OK: stop", lp->skipped, lp->clamped);
+             canvas_draw_str(c, 2, ROW_Y0 + 3 * ROW_DY, buf);
+         } else {
+             canvas_draw_str(c, 2, ROW_Y0 + 3 * ROW_DY, "OK: stop");
+         }
+     } else {
+         snprintf(buf, sizeof(buf), "File %u/%u  max %lu Hz", s->play_file + 1, s->play_files,
+             (unsigned long)profile_freq_max(active_profile(s)));
+         canvas_draw_str(c, 2, ROW_Y0 + ROW_DY, buf);
+         canvas_draw_str(c, 2, ROW_Y0 + 2 * ROW_DY, "UP/DN: file  </>: scale");
+         canvas_draw_str(c, 2, ROW_Y0 + 3 * ROW_DY, "OK: play");
+     }
+ }
+ 
+ static void playback_input(AppState* s, const InputEvent* ev, bool nav_ev){
+     if(ev->type == InputTypeShort && ev->key == InputKeyBack){ // BACK returns to menu
+         s->screen = ScreenMenu;                 // Keeps playing; caret where it was
+     } else if(ev->type == InputTypeShort && ev->key == InputKeyOk){
+         if(s->play) apply_mode(s, 0);           // Stop: Stand by
+         else play_start(s);
+     } else if(s->play){
+         return;                                 // File and scale only while stopped
+     } else if(nav_ev && (ev->key == InputKeyUp || ev->key == InputKeyDown) && s->play_files){
+         s->play_file = (uint16_t)((s->play_file + (ev->key == InputKeyDown ? 1 : s->play_files - 1)) %
+                                   s->play_files);
+         play_scan(s);
+     } else if(ev->type == InputTypeShort && ev->key == InputKeyRight &&
+               s->play_scale_idx + 1 < (int)PLAY_SCALE_COUNT){
+         s->play_scale_idx++;                    // Faster than real time
+     } else if(ev->type == InputTypeShort && ev->key == InputKeyLeft && s->play_scale_idx > 0){
+         s->play_scale_idx--;
+     }
+ }
+ 
+ /* ---------- Table-driven list screens ---------- */
+ /* Every list screen (inverter pick, main menu, settings) is a const row table walked by
+  * both draw_list() and list_input(). Adding a row means adding one table entry. */
+ typedef enum {
+     RowValueNone = 0,                           // Label only
+     RowValueText,                               // Right-aligned short text ("Yes"/"No")
+     RowValueCheck,                              // Right-side checkmark
+ } RowValueKind;
+ 
+ enum {
+     RowSelectable  = 1 << 0,                    // Caret can land here; OK runs the action
+     RowHeader      = 1 << 1,                    // Non-selectable caption drawn flush-left
+     RowSafeOnly    = 1 << 2,                    // Listed only while unpowered
+     RowPoweredOnly = 1 << 3,                    // Listed only while powered
+ };
+ 
+ typedef struct {
+     const char* label;                                       // Static label text
+     const char* (*label_fn)(const AppState* s, uint8_t arg); // Dynamic label (overrides label)
+     RowValueKind (*value_fn)(const AppState* s, uint8_t arg, const char** text); // Right side
+     void (*action)(AppState* s, uint8_t arg);                // OK handler
+     uint8_t (*count_fn)(const AppState* s);                  // Instances of this row (NULL => 1)
+     uint8_t flags;                                           // Row* bits above
+ } MenuRow;
+ 
+ typedef struct {
+     const char* title;                          // Fixed title (NULL => inverter title + countdown)
+     const MenuRow* rows;                        // Row table (NULL => custom screen)
+     uint8_t row_count;                          // Entries in rows[]
+     void (*back)(AppState* s);                  // Short BACK handler for list screens
+     void (*draw)(Canvas* c, const AppState* s); // Custom renderer (non-list screens)
+     void (*input)(AppState* s, const InputEvent* ev, bool nav_ev); // Custom input handler
+ } ScreenDesc;
+ 
+ typedef struct {
+     const MenuRow* row;                         // Table entry the visible row comes from
+     uint8_t arg;                                // Instance index within that entry
+ } MenuItem;
+ 
+ /* -- Row providers -- */
+ static const char* row_mode_label(const AppState* s, uint8_t arg){ return active_profile(s)->modes[arg].label; }
+ static uint8_t row_mode_count(const AppState* s){ return active_profile(s)->mode_count; }
+ static RowValueKind row_mode_value(const AppState* s, uint8_t arg, const char** text){
+     UNUSED(text);
+     return (arg == s->active) ? RowValueCheck : RowValueNone; // Check on the running mode
+ }
+ 
+ static const char* row_inv_label(const AppState* s, uint8_t arg){
+     return profile_at(s, arg)->name;
+ }
+ static uint8_t row_inv_count(const AppState* s){ return profile_total(s); }
+ static RowValueKind row_inv_value(const AppState* s, uint8_t arg, const char** text){
+     UNUSED(text);
+     return (arg == s->profile) ? RowValueCheck : RowValueNone; // Check on selected profile
+ }
+ 
+ static RowValueKind row_limit_value(const AppState* s, uint8_t arg, const char** text){
+     UNUSED(arg);
+     *text = s->limit_runtime ? "Yes" : "No";
+     return RowValueText;
+ }
+ static RowValueKind row_captcha_value(const AppState* s, uint8_t arg, const char** text){
+     UNUSED(arg);
+     *text = s->arrow_captcha ? "Yes" : "No";
+     return RowValueText;
+ }
+ static RowValueKind row_dark_value(const AppState* s, uint8_t arg, const char** text){
+     UNUSED(arg);
+     static const char* const labels[] = {"Off", "15s", "30s", "60s", "120s"}; // Matches kDarkAfterS
+     *text = labels[s->dark_idx];
+     return RowValueText;
+ }
+ static RowValueKind row_draw_value(const AppState* s, uint8_t arg, const char** text){
+     UNUSED(arg);
+     static char buf[16];                        // Only read by draw_list() right after the call
+     if(s->lit_ma < 0 && s->dark_ma < 0){ *text = "-"; return RowValueText; }
+     snprintf(buf, sizeof(buf), "%d/%dmA", s->lit_ma, s->dark_ma);
+     *text = buf;
+     return RowValueText;
+ }
+ static RowValueKind row_telem_value(const AppState* s, uint8_t arg, const char** text){
+     UNUSED(arg);
+     static const char* const labels[] = {"1s", "2s", "5s", "10s"}; // Matches kTelemetryPeriodS
+     *text = labels[s->telem_idx];
+     return RowValueText;
+ }
+ static RowValueKind row_temp_value(const AppState* s, uint8_t arg, const char** text){
+     UNUSED(arg);
+     static char buf[12];                        // Only read by draw_list() right after the call
+     if(!s->temp_probe) *text = "Off";
+     else if(s->temp_dc == PLOT_NO_VALUE) *text = s->ds.present ? "..." : "None";
+     else {
+         *text = temp_str(buf, sizeof(buf), s->temp_dc);
+     }
+     return RowValueText;
+ }
+ static RowValueKind row_hud_value(const AppState* s, uint8_t arg, const char** text){
+     UNUSED(arg);
+     *text = s->perf_hud ? "Yes" : "No";
+     return RowValueText;
+ }
+ 
+ /* -- Row actions -- */
+ static void act_pick_inverter(AppState* s, uint8_t arg){ // First screen: choose and enter menu
+     if(s->profile != arg) settings_touch(s);    // Remembered for the next launch
+     select_profile(s, arg);                     // Save choice
+     enter_safe_menu(s);                         // Jump into SAFE main menu
+     s->screen = ScreenMenu;                     // Switch screen to Menu
+ }
+ static void act_power_on(AppState* s, uint8_t arg){ // "Power on"
+     UNUSED(arg);
+     if(show_power_on_confirm()){                // Confirm safety alert first
+         if(enter_powered_menu_standby(s) && active_profile(s)->needs_5v){ // -> powered Stand by
+             static char msg[32];                // Ribbon text must outlive this call
+             snprintf(msg, sizeof(msg), "5V ready in %lu ms", (unsigned long)s->otg_settle_ms);
+             show_hint(s, msg, 2000);
+         }
+     }
+ }
+ static void act_mode(AppState* s, uint8_t arg){ apply_mode(s, arg); } // Run a powered mode
+ static void act_power_off(AppState* s, uint8_t arg){ UNUSED(arg); enter_safe_menu(s); }
+ static void act_settings(AppState* s, uint8_t arg){ UNUSED(arg); open_screen(s, ScreenSettings); }
+ static void act_plot(AppState* s, uint8_t arg){ UNUSED(arg); s->screen = ScreenPlot; } // Output unchanged
+ static void act_help(AppState* s, uint8_t arg){ // "Help": always read with output cut
+     UNUSED(arg);
+     if(s->powered) enter_safe_menu(s);          // Ensure safe state
+     s->screen = ScreenHelp;                     // Open help screen
+     s->help_top_line = 0;                       // Scroll to top
+     help_open(s);                               // SD guide for this inverter, if present
+     help_prefetch(s);                           // First screenful
+ }
+ static void act_toggle_limit(AppState* s, uint8_t arg){ // Toggle "Limit run time"
+     UNUSED(arg);
+     if(s->limit_runtime){                       // Turning OFF requires warning
+         if(show_limit_alert_confirm()){
+             s->limit_runtime = false;           // Disable limit
+             stop_timers(s);                     // Cancel any running timers
+             s->remaining_ms = 0;                // Clear countdown
+             settings_touch(s);
+         }
+     } else {
+         s->limit_runtime = true;                // Enable limit
+         start_tick_timer_if_needed(s);          // Possibly start timers
+         settings_touch(s);
+     }
+ }
+ static void act_toggle_captcha(AppState* s, uint8_t arg){
+     UNUSED(arg);
+     s->arrow_captcha = !s->arrow_captcha;
+     settings_touch(s);
+ }
+ static void act_toggle_temp(AppState* s, uint8_t arg){ UNUSED(arg); temp_enable(s, !s->temp_probe); }
+ static void act_toggle_hud(AppState* s, uint8_t arg){ UNUSED(arg); s->perf_hud = !s->perf_hud; settings_touch(s); }
+ static void act_battery(AppState* s, uint8_t arg){ UNUSED(arg); s->screen = ScreenBattery; } // Output unchanged
+ static void act_analog(AppState* s, uint8_t arg){ UNUSED(arg); s->screen = ScreenAnalog; } // Output unchanged
+ static void act_inrush(AppState* s, uint8_t arg){ UNUSED(arg); s->screen = ScreenInrush; } // Output unchanged
+ static void act_scope(AppState* s, uint8_t arg){ // Output unchanged: sampling only
+     UNUSED(arg);
+     if(s->adc_burst){                           // ADC1 busy for < 1 s: don't block the loop on it
+         show_hint(s, "Inrush capture running", 1500);
+         return;
+     }
+     scope_open(s);
+     s->screen = ScreenScope;
+ }
+ static void act_logic(AppState* s, uint8_t arg){ // Output unchanged: pins 3/4 listen only
+     UNUSED(arg);
+     if(s->adc_burst){                           // Pin 3 still sampled by a burst
+         show_hint(s, "Inrush capture running", 1500);
+         return;
+     }
+     logic_open(s);
+     s->screen = ScreenLogic;
+ }
+ static void act_run_hours(AppState* s, uint8_t arg){ // Output unchanged: lookup only
+     UNUSED(arg);
+     s->serial_edit = false;
+     runs_lookup(s);                             // Includes this session's finished segments
+     s->screen = ScreenRunHours;
+ }
+ static void act_model(AppState* s, uint8_t arg){ // Unpowered only: may change the profile
+     UNUSED(arg);
+     s->model_pos = (uint8_t)strlen(s->model_query); // Keep the last query, caret at its end
+     s->screen = ScreenModel;
+ }
+ static void act_playback(AppState* s, uint8_t arg){ // Powered only: the file drives the output
+     UNUSED(arg);
+     if(!s->play) play_scan(s);                  // Pick up files copied since last time
+     s->screen = ScreenPlayback;
+ }
+ static void act_fault(AppState* s, uint8_t arg){ // Output unchanged: reading is passive
+     UNUSED(arg);
+     fault_open(s);
+     s->screen = ScreenFault;
+ }
+ static void act_cycle_telem(AppState* s, uint8_t arg){ // 1s -> 2s -> 5s -> 10s -> 1s
+     UNUSED(arg);
+     s->telem_idx = (uint8_t)((s->telem_idx + 1) % TELEMETRY_PERIOD_COUNT);
+     telemetry_set_period(s->telemetry, kTelemetryPeriodS[s->telem_idx] * 1000U);
+     settings_touch(s);
+ }
+ static void act_cycle_dark(AppState* s, uint8_t arg){ // Off -> 15s -> 30s -> 60s -> 120s -> Off
+     UNUSED(arg);
+     s->dark_idx = (uint8_t)((s->dark_idx + 1) % DARK_AFTER_COUNT);
+     settings_touch(s);
+ }
+ static void act_settings_inverter(AppState* s, uint8_t arg){ // Settings radio: change inverter
+     if(s->profile == arg) return;               // Already selected: nothing to do
+     select_profile(s, arg);                     // Change selection
+     settings_touch(s);                          // Remembered for the next launch
+     enter_safe_menu(s);                         // Force SAFE state
+     s->screen = ScreenMenu;                     // Back to menu
+ }
+ 
+ /* -- BACK handlers -- */
+ static void back_show_hint(AppState* s){        // Short BACK shows "Long press back to exit"
+     show_hint(s, "Long press back to exit", 1500);
+ }
+ static void back_to_menu(AppState* s){ open_screen(s, ScreenMenu); } // Return to main menu
+ 
+ /* -- Row tables -- */
+ static const MenuRow kRowsSelectInverter[] = {
+     {.label_fn = row_inv_label, .count_fn = row_inv_count, .action = act_pick_inverter,
+      .flags = RowSelectable},
+ };
+ 
+ static const MenuRow kRowsMenu[] = {
+     {.label = "Power on",  .action = act_power_on,  .flags = RowSelectable | RowSafeOnly},
+     {.label_fn = row_mode_label, .count_fn = row_mode_count, .value_fn = row_mode_value,
+      .action = act_mode, .flags = RowSelectable | RowPoweredOnly},
+     {.label = "Power off", .action = act_power_off, .flags = RowSelectable | RowPoweredOnly},
+     {.label = "Playback",  .action = act_playback,  .flags = RowSelectable | RowPoweredOnly},
+     {.label = "Live plot", .action = act_plot,      .flags = RowSelectable},
+     {.label = "Battery",   .action = act_battery,   .flags = RowSelectable},
+     {.label = "Analog in", .action = act_analog,    .flags = RowSelectable},
+     {.label = "Inrush",    .action = act_inrush,    .flags = RowSelectable},
+     {.label = "Scope",     .action = act_scope,     .flags = RowSelectable},
+     {.label = "Logic",     .action = act_logic,     .flags = RowSelectable},
+     {.label = "Fault code", .action = act_fault,    .flags = RowSelectable},
+     {.label = "Run hours", .action = act_run_hours, .flags = RowSelectable},
+     {.label = "Model lookup", .action = act_model, .flags = RowSelectable | RowSafeOnly},
+     {.label = "Settings",  .action = act_settings,  .flags = RowSelectable},
+     {.label = "Help",      .action = act_help,      .flags = RowSelectable},
+ };
+ 
+ static const MenuRow kRowsSettings[] = {
+     {.label = "Limit run time", .value_fn = row_limit_value,   .action = act_toggle_limit,
+      .flags = RowSelectable},
+     {.label = "Arrow captcha",  .value_fn = row_captcha_value, .action = act_toggle_captcha,
+      .flags = RowSelectable},
+     {.label = "Dark run",       .value_fn = row_dark_value,    .action = act_cycle_dark,
+      .flags = RowSelectable},
+     {.label = "Draw lit/dark",  .value_fn = row_draw_value},   // Report only (not selectable)
+     {.label = "Telemetry",      .value_fn = row_telem_value,   .action = act_cycle_telem,
+      .flags = RowSelectable},
+     {.label = "Temp probe",     .value_fn = row_temp_value,    .action = act_toggle_temp,
+      .flags = RowSelectable},
+     {.label = "Perf HUD",       .value_fn = row_hud_value,     .action = act_toggle_hud,
+      .flags = RowSelectable},
+     {.label = "Inverter type",  .flags = RowHeader},
+     {.label_fn = row_inv_label, .count_fn = row_inv_count, .value_fn = row_inv_value,
+      .action = act_settings_inverter, .flags = RowSelectable},
+ };
+ 
+ #define ROWS(t) .rows = (t), .row_count = (uint8_t)(sizeof(t)/sizeof((t)[0])) // Table + size
+ 
+ static const ScreenDesc kScreens[] = {         // Indexed by ScreenId: O(1) lookup per event
+     [ScreenSelectInverter] = {.title = "Inverter type", ROWS(kRowsSelectInverter), .back = back_show_hint},
+     [ScreenMenu]           = {.title = NULL,            ROWS(kRowsMenu),           .back = back_show_hint},
+     [ScreenHelp]           = {.draw = draw_help, .input = help_input},
+     [ScreenSettings]       = {.title = "Settings",      ROWS(kRowsSettings),       .back = back_to_menu},
+     [ScreenPlot]           = {.draw = draw_plot, .input = plot_input},
+     [ScreenBattery]        = {.draw = draw_battery, .input = battery_input},
+     [ScreenFault]          = {.draw = draw_fault, .input = fault_input},
+     [ScreenAnalog]         = {.draw = draw_analog, .input = analog_input},
+     [ScreenInrush]         = {.draw = draw_inrush, .input = inrush_input},
+     [ScreenScope]          = {.draw = draw_scope, .input = scope_input},
+     [ScreenLogic]          = {.draw = draw_logic, .input = logic_input},
+     [ScreenRunHours]       = {.draw = draw_run_hours, .input = run_hours_input},
+     [ScreenModel]          = {.draw = draw_model, .input = model_input},
+     [ScreenPlayback]       = {.draw = draw_playback, .input = playback_input},
+ };
+ 
+ /* -- Table walking -- */
+ static uint8_t menu_row_instances(const AppState* s, const MenuRow* r){ // 0 if hidden
+     if((r->flags & RowSafeOnly) && s->powered) return 0;     // Safe-only row while powered
+     if((r->flags & RowPoweredOnly) && !s->powered) return 0; // Powered-only row while safe
+     return r->count_fn ? r->count_fn(s) : 1;                 // Repeated or single row
+ }
+ 
+ static uint8_t menu_row_total(const AppState* s, const ScreenDesc* d){ // Visible rows in screen
+     uint8_t total = 0;
+     for(uint8_t i = 0; i < d->row_count; i++) total = (uint8_t)(total + menu_row_instances(s, &d->rows[i]));
+     return total;
+ }
+ 
+ static bool menu_item_at(const AppState* s, const ScreenDesc* d, uint8_t idx, MenuItem* out){
+     for(uint8_t i = 0; i < d->row_count; i++){  // Walk the (short) table
+         uint8_t n = menu_row_instances(s, &d->rows[i]);
+         if(idx < n){                            // Row lies within this entry
+             out->row = &d->rows[i];
+             out->arg = idx;
+             return true;
+         }
+         idx = (uint8_t)(idx - n);               // Skip past this entry's rows
+     }
+     return false;                               // Out of range
+ }
+ 
+ typedef struct { const AppState* s; const ScreenDesc* d; } MenuNavCtx; // nav_move() predicate ctx
+ 
+ static bool menu_row_selectable(const void* ctx, uint8_t row){ // nav_move() predicate
+     const MenuNavCtx* m = ctx;
+     MenuItem it;
+     return menu_item_at(m->s, m->d, row, &it) && (it.row->flags & RowSelectable);
+ }
+ 
+ /* -- Generic list renderer -- */
+ static void draw_list(Canvas* c, const AppState* s, const ScreenDesc* d){
+     canvas_clear(c);                            // Clear the screen
+     if(d->title){                               // Fixed title
+         canvas_set_font(c, FontPrimary);
+         canvas_set_color(c, ColorBlack);
+         canvas_draw_str(c, 4, TITLE_Y, d->title);
+     } else {
+         draw_title(c, s);                       // Inverter title and possible countdown
+     }
+ 
+     canvas_set_font(c, FontSecondary);          // List font
+     const uint8_t row_total = menu_row_total(s, d);
+ 
+     uint8_t first_visible = s->first_visible;   // Clamp top-of-window index
+     if(first_visible + ROWS_VISIBLE > row_total){
+         first_visible = (row_total > ROWS_VISIBLE) ? (uint8_t)(row_total - ROWS_VISIBLE) : 0;
+     }
+ 
+     for(uint8_t i = 0; i < ROWS_VISIBLE; i++){  // Draw up to ROWS_VISIBLE rows
+         uint8_t row = (uint8_t)(first_visible + i); // Actual row index in the list
+         MenuItem it;
+         if(!menu_item_at(s, d, row, &it)) break; // Stop if out of range
+         int y = ROW_Y0 + i*ROW_DY;              // Baseline Y for this row
+         const char* label = it.row->label_fn ? it.row->label_fn(s, it.arg) : it.row->label;
+ 
+         if(it.row->flags & RowHeader){          // Caption: no caret, no value
+             canvas_draw_str(c, 4, y, label);
+             continue;
+         }
+ 
+         canvas_draw_str(c, 2, y, (row == s->cursor) ? ">" : " "); // Caret or space
+         canvas_draw_str(c, 14, y, label);       // Row label
+ 
+         const char* text = NULL;                // Right-side value, if any
+         RowValueKind kind = it.row->value_fn ? it.row->value_fn(s, it.arg, &text) : RowValueNone;
+         if(kind == RowValueText && text){       // Right-aligned value text
+             uint16_t w = canvas_string_width(c, text);
+             uint16_t right_x = (uint16_t)(SCROLLBAR_X - TIMER_MARGIN);
+             uint16_t x = (w <= right_x) ? (uint16_t)(right_x - w) : 2;
+             canvas_draw_str(c, x, y, text);
+         } else if(kind == RowValueCheck){       // Checkmark in the right area
+             int check_x = (int)SCROLLBAR_X - TIMER_MARGIN - 10;
+             if(check_x < 90) check_x = 90;      // Keep away from regular text
+             draw_checkmark(c, check_x, y);
+         }
+     }
+ 
+     draw_scrollbar_dotted(c, row_total, s->cursor); // Right-side scrollbar
+ 
+     if(s->hint_visible) draw_hint_ribbon(c, s->hint_msg); // Optional bottom hint ribbon
+ }
+ 
+ /* -- Generic list input -- */
+ static void list_input(AppState* s, const ScreenDesc* d, const InputEvent* ev, bool nav_ev){
+     if(nav_ev && (ev->key == InputKeyUp || ev->key == InputKeyDown)){ // Tap or hold
+         MenuNavCtx ctx = {.s = s, .d = d};
+         nav_move(&s->cursor, &s->first_visible, menu_row_total(s, d), ROWS_VISIBLE,
+                  (ev->key == InputKeyUp) ? -1 : 1, // Direction
+                  nav_step(s, ev->type),           // Accelerated step
+                  ev->type == InputTypeShort,       // Only taps wrap
+                  menu_row_selectable, &ctx);       // Skip headers
+     } else if(ev->type == InputTypeShort){      // Other keys react to short presses only
+         if(ev->key == InputKeyOk){              // Activate selected row
+             MenuItem it;
+             if(menu_item_at(s, d, s->cursor, &it) && (it.row->flags & RowSelectable) && it.row->action){
+                 it.row->action(s, it.arg);
+             }
+         } else if(ev->key == InputKeyBack && d->back){ // Screen-specific BACK
+             d->back(s);
+         }
+     }
+ }
+ 
+ /* ---------- Performance HUD ---------- */
+ static void perf_roll(AppState* s){             // Main loop: publish counters once per second
+     PerfStats* p = &s->perf;
+     uint32_t now = furi_get_tick();
+     uint32_t elapsed = now - p->window_start;   // Ticks in this window
+     if(elapsed < furi_ms_to_ticks(1000)) return; // Window not complete yet
+ 
+     uint32_t ms = elapsed * 1000U / furi_kernel_get_tick_frequency(); // Exact window length
+     p->loops_ps    = (uint16_t)((p->loops  * 1000U + ms / 2) / ms);
+     p->frames_ps   = (uint16_t)((p->frames * 1000U + ms / 2) / ms);
+     p->draw_avg_us = p->frames ? perf_cyc_to_us(p->draw_cyc_sum / p->frames) : 0;
+     p->draw_max_us = perf_cyc_to_us(p->draw_cyc_max);
+     p->jitter_us   = perf_cyc_to_us(p->jitter_cyc_max);
+     p->free_heap   = (uint32_t)memmgr_get_free_heap();
+ 
+     p->loops = p->frames = 0;                   // Start a new window
+     p->draw_cyc_sum = p->draw_cyc_max = p->jitter_cyc_max = 0;
+     p->window_start = now;
+ 
+     if(s->perf_hud) ui_refresh(s);              // Keep overlay fresh while idle
+ }
+ 
+ static void draw_perf_hud(Canvas* c, const PerfStats* p){ // Two-line overlay at the bottom
+     char l1[32], l2[32];
+     snprintf(l1, sizeof(l1), "L%u F%u D%lu/%luus",
+         p->loops_ps, p->frames_ps, (unsigned long)p->draw_avg_us, (unsigned long)p->draw_max_us);
+     snprintf(l2, sizeof(l2), "I%lums J%luus H%luK",
+         (unsigned long)((p->latency_us + 500) / 1000), (unsigned long)p->jitter_us,
+         (unsigned long)(p->free_heap / 1024));
+ 
+     canvas_set_color(c, ColorWhite);            // Clear a strip so the text stays legible
+     canvas_draw_box(c, 0, CANVAS_H - 19, CANVAS_W, 19);
+     canvas_set_color(c, ColorBlack);
+     canvas_draw_line(c, 0, CANVAS_H - 19, CANVAS_W - 1, CANVAS_H - 19); // Separator
+     canvas_set_font(c, FontKeyboard);           // Compact font
+     canvas_draw_str(c, 1, CANVAS_H - 10, l1);
+     canvas_draw_str(c, 1, CANVAS_H - 1,  l2);
+ }
+ 
+ /* ---------- Draw dispatcher ---------- */
+ static void draw_cb(Canvas* c, void* ctx){      // ViewPort draw callback
+     AppState* s = ctx;                          // Cast context back to AppState
+     uint32_t t0 = perf_cycles();                // Draw time, excluding the HUD itself
+ 
+     const ScreenDesc* d = &kScreens[s->screen]; // Table lookup instead of a switch
+     if(d->draw) d->draw(c, s);                  // Custom screen
+     else draw_list(c, s, d);                    // Table-driven list
+ 
+     uint32_t dt = perf_cycles() - t0;
+     s->perf.frames++;
+     s->perf.draw_cyc_sum += dt;
+     if(dt > s->perf.draw_cyc_max) s->perf.draw_cyc_max = dt;
+ 
+     if(s->perf_hud) draw_perf_hud(c, &s->perf); // Optional overlay
+ }
+ 
+ /* ---------- Input queue plumbing ---------- */
+ typedef struct { FuriMessageQueue* q; } InputCtx; // Wrapper to pass queue to callback
+ typedef struct {
+     InputEvent input;                           // Event as delivered by the GUI
+     uint32_t cyc;                               // Cycle stamp at delivery (HUD input latency)
+ } QueuedInput;
+ static void vp_input_cb(InputEvent* e, void* ctx){ // ViewPort input callback (ISR-ish context)
+     InputCtx* ic = ctx;                         // Recover wrapper
+     QueuedInput qi = {.input = *e, .cyc = perf_cycles()}; // Copy event + arrival time
+     furi_message_queue_put(ic->q, &qi, 0);      // Push event to queue (non-blocking)
  }
  
  /* ---------- Application entry point ---------- */
@@ -658,7 +2765,9 @@
  
      AppState s = {                               // Initialize all state fields explicitly
          .screen = ScreenSelectInverter,         // Start on inverter selection screen
-         .inverter = InvEmbraco,                 // Default selection (user can change)
+         .profile = InvEmbraco,                  // Default selection (user can change)
+         .family = &kInverterFamilies[InvEmbraco], // Family of the default selection
+         .profiles = {0},                        // Loaded from the SD card below
          .powered = false,                       // Start in SAFE state
          .cursor = 0,                            // Start with first row selected
          .first_visible = 0,                     // Top of list window
@@ -667,11 +2776,62 @@
          .limit_runtime = true,                  // Enforce per-mode timeouts by default
          .arrow_captcha = true,                  // Placeholder toggle default is Yes
          .notif = furi_record_open(RECORD_NOTIFICATION), // Acquire Notification service handle
-         .led_timer = NULL,                      // No LED timer yet
-         .led_on = false,                        // LED off initially
+         .led_slots = {{{0}}},                   // Filled by led_apply()
+         .led_slot = 0,                          // Start with the first slot
+         .led_hz = LED_HZ_UNKNOWN,               // LED state unknown until first apply
          .pwm_running = false,                   // PWM not running
+         .freq_hz = 0,                           // Nothing commanded
+         .plot = NULL,                           // Allocated below
+         .plot_timer = NULL,                     // Allocated below
+         .perf_hud = false,                      // Overlay off by default
+         .perf = {0},                            // Counters start at zero
+         .dark_idx = 0,                          // Dark run off by default
+         .dark = false,                          // Display lit
+         .wake_swallow = false,                  // No pending wake key
+         .last_input_tick = 0,                   // Set when the loop starts
+         .dark_sample_tick = 0,                  // Set when going dark
+         .dark_ma_sum = 0,                       // No dark samples yet
+         .dark_ma_count = 0,
+         .lit_ma = -1,                           // Not measured yet
+         .dark_ma = -1,                          // Not measured yet
+         .telemetry = NULL,                      // Allocated below
+         .telem_idx = 0,                         // 1 s sampling
+         .runtime_est_s = TELEMETRY_RUNTIME_UNKNOWN, // No estimate until samples arrive
+         .otg_settle_ms = 0,                     // Not measured yet
+         .rail_lost = false,                     // No rail failure pending
+         .fault = NULL,                          // Allocated when the fault screen opens
+         .analog_cfg = 0,                        // Analog inputs off
+         .analog = NULL,                         // Allocated by analog_start()
+         .analog_pub_tick = 0,
+         .analog_mv = PLOT_NO_VALUE,             // No trace until a window is published
+         .inrush = NULL,                         // Disarmed
+         .inrush_pending = false,                // No burst requested
+         .adc_burst = false,                     // ADC1 free
+         .scope = NULL,                          // Scope closed
+         .logic = NULL,                          // Logic analyzer closed
+         .logic_rate_idx = 0,                    // 1 MHz
+         .play = NULL,                           // Not playing
+         .play_timer = NULL,                     // Allocated on the first playback
+         .play_scale_idx = 0,                    // Real time
+         .play_file = 0,                         // First file in the directory
+         .temp_probe = false,                    // Pin 17 untouched until enabled
+         .ds = {0},                              // Set up by temp_enable()
+         .temp_dc = PLOT_NO_VALUE,               // No reading yet
+         .nav_press_tick = 0,                    // No key held yet
+         .log = NULL,                            // Started below
+         .serial = "",                           // Not tracked until set (or loaded)
+         .runs = NULL,                           // Opened below
+         .seg_mode = 0,                          // No run segment open
+         .seg_tick = 0,
+         .unit = {0},
+         .unit_found = false,
+         .serial_edit = false,
+         .serial_pos = 0,
+         .settings_dirty = false,                // Nothing to write yet
+         .settings_tick = 0,
          .hint_visible = false,                  // Hint ribbon hidden
          .hint_timer = NULL,                     // No hint timer
+         .hint_msg = NULL,                       // Set together with hint_visible
          .tick_timer = NULL,                     // No 1 Hz timer
          .off_timer = NULL,                      // No one-shot timer
          .remaining_ms = 0,                      // No countdown active
@@ -683,8 +2843,10 @@
  
      s.gui = furi_record_open(RECORD_GUI);       // Acquire GUI service
      s.vp = view_port_alloc();                   // Create a ViewPort (draw+input)
-     s.q  = furi_message_queue_alloc(8, sizeof(InputEvent)); // Create queue for input events
+     s.q  = furi_message_queue_alloc(8, sizeof(QueuedInput)); // Create queue for input events
      InputCtx ic = {.q = s.q};                   // Wrap queue to pass into input callback
+     s.help_cache = malloc(sizeof(HelpCache));   // 8 decoded lines (~300 B); before any draw
+     help_cache_reset(s.help_cache);
  
      view_port_draw_callback_set(s.vp, draw_cb, &s); // Attach draw callback with AppState context
      view_port_input_callback_set(s.vp, vp_input_cb, &ic); // Attach input callback with queue wrapper
@@ -694,220 +2856,175 @@
      power_5v_set(false);                        // Make sure OTG 5V is OFF at start
      led_apply(&s, 0);                           // Ensure LED is off (no blink)
  
-     const uint8_t MAX_ROWS = 4;                 // Used for wrapping navigation (visible height)
-     (void)MAX_ROWS;                             // Silence “unused variable” warnings if any
+     Storage* storage = furi_record_open(RECORD_STORAGE); // Held for s.runs until exit
+     profile_pack_load(&s.profiles, storage, PROFILE_DIR, PROFILE_CACHE); // Cached after first load
+     storage_simply_mkdir(storage, EXT_PATH("apps_data"));
+     storage_simply_mkdir(storage, RUNS_DIR);
+     s.runs = malloc(sizeof(RunDb));             // Index + pending records (~3 KB)
+     run_db_open(s.runs, storage, RUNS_DIR);     // Journal tail -> index; compacts when long
+     furi_assert(model_db_sorted());             // Model lookups binary-search it (debug builds)
+     settings_load(&s);                          // Last session's choices (after the pack: by name)
+     s.log = malloc(sizeof(RunLog));             // Ring + block buffer (~1.6 KB)
+     run_log_start(s.log, RUN_LOG_DIR);          // File appears with the first event
+ 
+     ProbeResult probe = inverter_probe();       // Passive look at PA7 (pulls only, < 1 s)
+     if(kProbeGuess[probe].inverter >= 0 &&      // The probe only tells the signal class apart:
+        inverter_family_get((uint8_t)kProbeGuess[probe].inverter)->profile.needs_5v !=
+        active_profile(&s)->needs_5v){           // a saved Secop / Tecumseh / LG of that class stays
+         select_profile(&s, (uint8_t)kProbeGuess[probe].inverter); // Built-in of that family
+     }
+     s.cursor = profile_row(&s);                 // Caret on the saved / detected inverter
+     if(s.cursor >= ROWS_VISIBLE) s.first_visible = (uint8_t)(s.cursor - (ROWS_VISIBLE - 1));
+     show_hint(&s, kProbeGuess[probe].hint, 3000); // Still needs OK to confirm
+     if(s.profiles.rejected){                    // Broken SD profile: say so instead
+         static char msg[32];                    // Ribbon text must outlive this call
+         snprintf(msg, sizeof(msg), "%u profile file(s) rejected", s.profiles.rejected);
+         show_hint(&s, msg, 3000);
+     }
+ 
+     s.plot = malloc(sizeof(Plot));              // Too big for the 2 KB app stack
+     plot_reset(s.plot, (uint16_t)profile_freq_max(active_profile(&s)));
+     s.plot_timer = furi_timer_alloc(plot_timer_cb, FuriTimerTypePeriodic, &s);
+     s.telemetry = malloc(sizeof(Telemetry));    // Ring lives on the heap as well
+     telemetry_reset(s.telemetry, kTelemetryPeriodS[s.telem_idx] * 1000U);
+     telemetry_set_sink(s.telemetry, telemetry_log_sink, &s); // Samples go to the run log
+     furi_timer_start(s.plot_timer, furi_ms_to_ticks(PLOT_PERIOD_MS)); // Sample from launch on
  
      bool exit_app = false;                      // Main loop termination flag
-     InputEvent ev;                              // Local buffer for input events
+     QueuedInput qi;                             // Local buffer for queued input
+     InputEvent ev;                              // Event part of qi
+     s.perf.window_start = furi_get_tick();      // First HUD window starts now
+     s.last_input_tick = furi_get_tick();        // Inactivity measured from launch
  
      while(!exit_app){                           // Main event loop
          if(s.timeout_expired){                  // If one-shot auto-off timer fired…
              s.timeout_expired = false;          // -> clear flag
+             log_event(&s, RunLogAutoOff, 0, active_profile(&s)->modes[s.active].label);
              enter_powered_menu_standby(&s);     // -> fall back to powered Stand by
-             view_port_update(s.vp);             // -> request immediate redraw
+             ui_refresh(&s);                     // -> request immediate redraw
+         }
+         if(s.rail_lost){                        // If PWM start found the 5V rail down…
+             s.rail_lost = false;                // -> clear flag
+             log_event(&s, RunLogError, 0, "5V rail lost");
+             enter_safe_menu(&s);                // -> everything off
+             show_hint(&s, "5V rail lost: powered off", 3000);
+             ui_refresh(&s);                     // -> request immediate redraw
+         }
+         if(s.inrush_pending){                   // If a speed change armed a burst…
+             s.inrush_pending = false;           // -> clear flag
+             inrush_fire(&s);                    // -> start DMA capture (t = 0)
+         }
+ 
+         bool got = furi_message_queue_get(s.q, &qi, 100) == FuriStatusOk; // Wait up to 100ms for input
+         s.perf.loops++;                         // HUD: count every wakeup
+         perf_roll(&s);                          // HUD: publish once per second
+         dark_poll(&s);                          // Dark run: go dark after inactivity
+         settings_poll(&s);                      // Flush settings after a quiet period
+         runs_poll(&s);                          // Journal finished runs once unpowered
+         if(telemetry_poll(s.telemetry)){        // New fuel-gauge sample
+             runtime_guard(&s);                  // -> update estimate, stop if battery can't last
+             ui_refresh(&s);                     // -> estimate / battery screen changed
+         }
+         if(inrush_poll(&s) && s.screen == ScreenInrush){ // Burst complete and analysed
+             ui_refresh(&s);                     // -> show peak / settle / waveform
+         }
+         if(analog_poll(&s) && s.screen == ScreenAnalog){ // New analog window published
+             ui_refresh(&s);                     // -> min/avg/max changed
+         }
+         if(temp_poll(&s) && (s.screen == ScreenSettings || s.screen == ScreenPlot)){
+             ui_refresh(&s);                     // -> new probe reading
          }
+         if(logic_poll(&s)){                     // Logic capture running
+             ui_refresh(&s);                     // -> progress / run count changed
+         }
+         if(play_poll(&s) && s.screen == ScreenPlayback){ // Playback: buffer refilled
+             ui_refresh(&s);                     // -> position / speed changed
+         }
+         if(s.fault && fault_poll(&s)){          // Fault screen open: decode captured edges
+             ui_refresh(&s);                     // -> blink count / code changed
+         }
+ 
+         if(got){                                // An input event arrived
+             ev = qi.input;                      // Unwrap event
+             s.last_input_tick = furi_get_tick(); // Any key resets the dark-run countdown
  
-         if(furi_message_queue_get(s.q, &ev, 100) == FuriStatusOk){ // Wait up to 100ms for input
+             if(s.dark){                         // First key while dark only wakes the display
+                 dark_exit(&s);
+                 s.wake_swallow = (ev.type != InputTypeRelease); // Eat the rest of this key
+                 continue;
+             }
+             if(s.wake_swallow){                 // Still the waking key: no blind actions
+                 if(ev.type == InputTypeRelease) s.wake_swallow = false;
+                 continue;
+             }
+             s.perf.input_cyc = qi.cyc;          // apply_mode() measures latency from here
              if(ev.type == InputTypeLong && ev.key == InputKeyBack){ // Long BACK exits app
                  exit_app = true;                 // -> set termination flag
                  view_port_update(s.vp);          // -> repaint once more (optional)
                  continue;                        // -> go next loop iteration (will exit)
              }
  
-             switch(s.screen){                    // Dispatch per-screen input logic
-                 case ScreenSelectInverter: {     // Inverter selection screen
-                     if(ev.type == InputTypeShort || ev.type == InputTypeRepeat){ // Short or held
-                         if(ev.key == InputKeyUp){           // UP toggles between 0 and 1
-                             s.cursor = (s.cursor == 0) ? 1 : 0;
-                         } else if(ev.key == InputKeyDown){  // DOWN toggles between 1 and 0
-                             s.cursor = (s.cursor == 1) ? 0 : 1;
-                         } else if(ev.key == InputKeyOk){    // OK applies selection
-                             s.inverter = (s.cursor == 0) ? InvEmbraco : InvSamsung; // Save choice
-                             enter_safe_menu(&s);             // Jump into SAFE main menu
-                             s.screen = ScreenMenu;           // Switch screen to Menu
-                         } else if(ev.key == InputKeyBack){  // Short BACK shows hint ribbon
-                             s.hint_visible = true;           // -> make ribbon visible
-                             if(!s.hint_timer){               // -> allocate one-shot timer once
-                                 s.hint_timer =
-                                     furi_timer_alloc(hint_timer_cb, FuriTimerTypeOnce, &s);
-                             }
-                             furi_timer_start(                 // -> start ~1.5s hide timer
-                                 s.hint_timer, furi_ms_to_ticks(1500));
-                         }
-                     }
-                 } break;
- 
-                 case ScreenMenu: {               // Main menu (safe or powered)
-                     const bool powered = s.powered;          // Snapshot
-                     uint8_t row_total = powered              // Compute row count
-                         ? (uint8_t)(MODE_COUNT + 3)
-                         : 3;
- 
-                     if(ev.type == InputTypeShort){           // React to short presses only
-                         if(ev.key == InputKeyUp){            // Move selection up (with wrap)
-                             if(s.cursor == 0){
-                                 s.cursor = (uint8_t)(row_total - 1); // Wrap to bottom
-                                 s.first_visible =
-                                     (row_total > MAX_ROWS) ? (uint8_t)(row_total - MAX_ROWS) : 0;
-                             } else {
-                                 s.cursor--;                  // Move up one
-                                 if(s.cursor < s.first_visible) s.first_visible = s.cursor; // Scroll up
-                             }
-                         } else if(ev.key == InputKeyDown){   // Move selection down (with wrap)
-                             if(s.cursor == (uint8_t)(row_total - 1)){
-                                 s.cursor = 0;                // Wrap to top
-                                 s.first_visible = 0;         // Reset window
-                             } else {
-                                 s.cursor++;                  // Move down one
-                                 if(s.cursor >= s.first_visible + MAX_ROWS){ // Scroll window down
-                                     s.first_visible = (uint8_t)(s.cursor - (MAX_ROWS - 1));
-                                 }
-                             }
-                         } else if(ev.key == InputKeyOk){     // Activate selected item
-                             if(powered){
-                                 if(s.cursor < MODE_COUNT){   // One of the powered modes
-                                     apply_mode(&s, s.cursor);// -> run that mode
-                                 } else if(s.cursor == MODE_COUNT){ // "Power off"
-                                     enter_safe_menu(&s);     // -> go to SAFE (unpowered)
-                                 } else if(s.cursor == MODE_COUNT + 1){ // "Settings"
-                                     s.screen = ScreenSettings; // -> settings screen
-                                     s.cursor = 0;            // -> reset cursor
-                                     s.first_visible = 0;     // -> reset window
-                                 } else {                     // "Help"
-                                     enter_safe_menu(&s);     // -> ensure safe state
-                                     s.screen = ScreenHelp;   // -> open help screen
-                                     s.help_top_line = 0;     // -> scroll to top
-                                 }
-                             } else {                          // SAFE menu actions
-                                 if(s.cursor == 0){            // "Power on"
-                                     if(show_power_on_confirm()){ // -> confirm safety alert
-                                         enter_powered_menu_standby(&s); // -> powered Stand by
-                                     }
-                                 } else if(s.cursor == 1){     // "Settings"
-                                     s.screen = ScreenSettings;// -> go to settings
-                                     s.cursor = 0;             // -> reset cursor
-                                     s.first_visible = 0;      // -> reset window
-                                 } else {                      // "Help"
-                                     s.screen = ScreenHelp;    // -> help screen
-                                     s.help_top_line = 0;      // -> scroll to top
-                                 }
-                             }
-                         } else if(ev.key == InputKeyBack){   // Short BACK => show hint ribbon
-                             s.hint_visible = true;            // -> show
-                             if(!s.hint_timer){                // -> allocate one-shot timer if needed
-                                 s.hint_timer =
-                                     furi_timer_alloc(hint_timer_cb, FuriTimerTypeOnce, &s);
-                             }
-                             furi_timer_start(                  // -> arm auto-hide after ~1.5s
-                                 s.hint_timer, furi_ms_to_ticks(1500));
-                         }
-                     }
-                 } break;
- 
-                 case ScreenHelp: {              // Help view with vertical scrolling
-                     if(ev.type == InputTypeShort || ev.type == InputTypeRepeat){
-                         const uint8_t total_lines =         // Determine content length by inverter
-                             (s.inverter == InvEmbraco) ? HELP_EMBRACO_COUNT : HELP_SAMSUNG_COUNT;
-                         uint8_t max_lines, max_top_line;    // Calculate display capacity and max scroll
-                         help_layout_params(total_lines, &max_lines, &max_top_line);
- 
-                         if(ev.key == InputKeyUp){           // Scroll up if not already at top
-                             if(s.help_top_line > 0) s.help_top_line--;
-                         } else if(ev.key == InputKeyDown){  // Scroll down if not at end
-                             if(s.help_top_line < max_top_line) s.help_top_line++;
-                         } else if(ev.key == InputKeyBack){  // Short BACK returns to menu
-                             s.screen = ScreenMenu;
-                         }
-                     }
-                 } break;
- 
-                 case ScreenSettings: {          // Settings interactions
-                     const uint8_t ROW_TOTAL = 5;            // Total rows including header
-                     const uint8_t MAX_ROWS_S = 4;           // Visible rows
- 
-                     if(ev.type == InputTypeShort){
-                         if(ev.key == InputKeyUp){           // Move selection up (skip header)
-                             if(s.cursor == 0){
-                                 s.cursor = (uint8_t)(ROW_TOTAL - 1);
-                                 s.first_visible =
-                                     (ROW_TOTAL > MAX_ROWS_S) ? (uint8_t)(ROW_TOTAL - MAX_ROWS_S) : 0;
-                             } else {
-                                 s.cursor--;
-                                 if(s.cursor == 2) s.cursor = 1; // Skip non-selectable header row
-                                 if(s.cursor < s.first_visible) s.first_visible = s.cursor;
-                             }
-                         } else if(ev.key == InputKeyDown){  // Move selection down (skip header)
-                             if(s.cursor == (uint8_t)(ROW_TOTAL - 1)){
-                                 s.cursor = 0;
-                                 s.first_visible = 0;
-                             } else {
-                                 s.cursor++;
-                                 if(s.cursor == 2) s.cursor = 3; // Skip header
-                                 if(s.cursor >= s.first_visible + MAX_ROWS_S){
-                                     s.first_visible = (uint8_t)(s.cursor - (MAX_ROWS_S - 1));
-                                 }
-                             }
-                         } else if(ev.key == InputKeyOk){    // Activate/toggle selected row
-                             if(s.cursor == 0){               // Toggle "Limit run time"
-                                 if(s.limit_runtime){         // Turning OFF requires warning
-                                     if(show_limit_alert_confirm()){
-                                         s.limit_runtime = false; // Disable limit
-                                         stop_timers(&s);         // Cancel any running timers
-                                         s.remaining_ms = 0;      // Clear countdown
-                                     }
-                                 } else {
-                                     s.limit_runtime = true;  // Enable limit
-                                     start_tick_timer_if_needed(&s); // Possibly start timers
-                                 }
-                             } else if(s.cursor == 1){        // Toggle "Arrow captcha" (placeholder)
-                                 s.arrow_captcha = !s.arrow_captcha;
-                             } else if(s.cursor == 3){        // Select "Embraco" inverter
-                                 if(s.inverter != InvEmbraco){
-                                     s.inverter = InvEmbraco; // Change selection
-                                     enter_safe_menu(&s);     // Force SAFE state
-                                     s.screen = ScreenMenu;   // Back to menu
-                                 }
-                             } else if(s.cursor == 4){        // Select "Samsung" inverter
-                                 if(s.inverter != InvSamsung){
-                                     s.inverter = InvSamsung; // Change selection
-                                     enter_safe_menu(&s);     // Force SAFE state
-                                     s.screen = ScreenMenu;   // Back to menu
-                                 }
-                             }
-                         } else if(ev.key == InputKeyBack){  // BACK returns to main menu
-                             s.screen = ScreenMenu;
-                             s.cursor = 0;
-                             s.first_visible = 0;
-                         }
-                     }
-                 } break;
-             } // end switch
- 
-             view_port_update(s.vp);             // After handling input, request a redraw
+             if(ev.type == InputTypePress &&      // Remember when UP/DOWN went down so
+                (ev.key == InputKeyUp || ev.key == InputKeyDown)){ // held keys can accelerate
+                 s.nav_press_tick = furi_get_tick();
+             }
+             const bool nav_ev =                  // Events that move a list cursor:
+                 ev.type == InputTypeShort ||     // -> tap (wraps at the ends)
+                 ev.type == InputTypeLong ||      // -> hold start
+                 ev.type == InputTypeRepeat;      // -> hold continues (accelerates)
+ 
+             const ScreenDesc* d = &kScreens[s.screen]; // O(1) screen lookup
+             if(d->input) d->input(&s, &ev, nav_ev);  // Custom screen (help, scope, playback, ...)
+             else list_input(&s, d, &ev, nav_ev);     // Table-driven list screen
+             s.perf.input_cyc = 0;                    // Later applies (auto-off) are not input
+ 
+             ui_refresh(&s);                     // After handling input, request a redraw
          } // end if(get queue)
      } // end while(!exit_app)
  
      /* ---------- Cleanup: return hardware and services to safe state ---------- */
-     if(s.led_timer){
-         furi_timer_stop(s.led_timer);
-         furi_timer_free(s.led_timer);
-         s.led_timer = NULL;
-     }
      if(s.hint_timer){
          furi_timer_stop(s.hint_timer);
          furi_timer_free(s.hint_timer);
          s.hint_timer = NULL;
      }
-     stop_timers(&s);
+     if(s.dark) notification_message(s.notif, &sequence_display_backlight_on); // Never exit dark
+     settings_flush(&s);                         // Changes still inside the quiet period
+     furi_timer_stop(s.plot_timer);
+     furi_timer_free(s.plot_timer);
+     stop_timers(&s);                            // Countdown ticks redraw: off before the view port
+     if(s.scope) furi_timer_stop(s.scope->timer); // Frame-ready redraws too
+ 
+     gui_remove_view_port(s.gui, s.vp);          // No draw callback from here on:
+     view_port_free(s.vp);                       // state the draw_* functions read can go
+     s.vp = NULL;                                // ui_refresh() is a no-op from here
+     free(s.plot);                               // After the view port: draw_plot uses it
+     free(s.telemetry);                          // After the view port: draw_battery uses it
+     fault_close(&s);                            // After the view port (draw_fault); releases TIM2
+     scope_close(&s);                            // After the view port: draw_scope uses it
+     logic_close(&s);                            // After the view port (draw_logic); TIM2 / DMA
+     play_stop(&s);                              // Scheduler off before PWM is released
+     if(s.play_timer) furi_timer_free(s.play_timer);
+     if(s.temp_probe) temp_enable(&s, false);    // Pin 17 back to Hi-Z
+     inrush_arm(&s, false);                      // Abort a running burst, free its buffer
+     analog_stop(&s);                            // Release ADC1 / DMA
      free_timers(&s);
      pwm_hw_stop_safe(&s.pwm_running);
      pin_to_hiz();
      power_5v_set(false);
+     notification_message(s.notif, &sequence_blink_stop);
      notification_message(s.notif, &sequence_reset_rgb);
      furi_record_close(RECORD_NOTIFICATION);
- 
-     gui_remove_view_port(s.gui, s.vp);
-     view_port_free(s.vp);
+     if(s.powered) log_event(&s, RunLogPowerOff, 0, "app exit");
+     runs_segment_end(&s);                       // Exit while running still counts
+     run_db_close(s.runs);                       // Flush; compact when due
+     free(s.runs);
+     furi_record_close(RECORD_STORAGE);          // Opened for the run-hours DB at launch
+     run_log_stop(s.log);                        // Drain + close before the profile names go
+     free(s.log);
+     help_close(&s);                             // Exit from the help screen
+     profile_pack_free(&s.profiles);             // After the view port and plot timer: title names
+     free(s.help_cache);                         // After the view port: draw_help uses it
      furi_message_queue_free(s.q);
      furi_record_close(RECORD_GUI);
      return 0;
@@ -0,0 +1,78 @@
+/*******************************************************************************************
+ * Expert Tool ICS — fault line input capture (see fault_capture.h)
+ *******************************************************************************************/
+ #include "fault_capture.h"
+ #include <furi_hal.h>                           // GPIO, bus clocks, interrupt table
+ #include <stm32wbxx_ll_tim.h>                   // TIM2 input capture
+ #include <string.h>                             // memset
+ 
+ #define FAULT_PIN (&gpio_ext_pb3)               // Header pin 5 = TIM2_CH2 (AF1)
+ #define FAULT_TIM_PRESCALER 63                  // 64 MHz / 64 = 1 MHz -> 1 µs per count
+ 
+ static void fault_capture_isr(void* ctx){      // TIM2 IRQ: keep it to a copy
+     FaultCapture* fc = ctx;
+     if(!LL_TIM_IsActiveFlag_CC2(TIM2)) return;
+     LL_TIM_ClearFlag_CC2(TIM2);
+ 
+     uint32_t t = LL_TIM_IC_GetCaptureCH2(TIM2); // Latched by hardware at the edge
+     bool level = furi_hal_gpio_read(FAULT_PIN); // Slow line: level is settled by now
+     uint16_t head = fc->head;
+     uint16_t next = (head + 1) & (FAULT_CAPTURE_EDGES - 1);
+     if(next == fc->tail){                       // Full: keep old edges, count the loss
+         fc->dropped++;
+         return;
+     }
+     fc->ring[head].t_us = t;
+     fc->ring[head].level = level;
+     fc->head = next;                            // Publish after the slot is written
+ }
+ 
+ void fault_capture_start(FaultCapture* fc){
+     memset(fc, 0, sizeof(*fc));
+ 
+     furi_hal_bus_enable(FuriHalBusTIM2);
+     furi_hal_gpio_init_ex(FAULT_PIN, GpioModeAltFunctionPushPull, GpioPullUp,
+                           GpioSpeedLow, GpioAltFn1TIM2); // Pull-up suits open-collector outputs
+ 
+     LL_TIM_SetPrescaler(TIM2, FAULT_TIM_PRESCALER);
+     LL_TIM_SetAutoReload(TIM2, UINT32_MAX);     // Free-running 32-bit, wraps after ~71 min
+     LL_TIM_SetCounterMode(TIM2, LL_TIM_COUNTERMODE_UP);
+     LL_TIM_IC_SetActiveInput(TIM2, LL_TIM_CHANNEL_CH2, LL_TIM_ACTIVEINPUT_DIRECTTI);
+     LL_TIM_IC_SetPrescaler(TIM2, LL_TIM_CHANNEL_CH2, LL_TIM_ICPSC_DIV1);
+     LL_TIM_IC_SetFilter(TIM2, LL_TIM_CHANNEL_CH2, LL_TIM_IC_FILTER_FDIV32_N8); // ~4 µs deglitch
+     LL_TIM_IC_SetPolarity(TIM2, LL_TIM_CHANNEL_CH2, LL_TIM_IC_POLARITY_BOTHEDGE);
+     LL_TIM_CC_EnableChannel(TIM2, LL_TIM_CHANNEL_CH2);
+ 
+     LL_TIM_GenerateEvent_UPDATE(TIM2);          // Load the prescaler now
+     LL_TIM_ClearFlag_UPDATE(TIM2);
+     LL_TIM_ClearFlag_CC2(TIM2);
+     furi_hal_interrupt_set_isr(FuriHalInterruptIdTIM2, fault_capture_isr, fc);
+     LL_TIM_EnableIT_CC2(TIM2);
+     LL_TIM_EnableCounter(TIM2);
+ }
+ 
+ void fault_capture_stop(FaultCapture* fc){
+     UNUSED(fc);
+     LL_TIM_DisableIT_CC2(TIM2);
+     LL_TIM_DisableCounter(TIM2);
+     LL_TIM_CC_DisableChannel(TIM2, LL_TIM_CHANNEL_CH2);
+     furi_hal_interrupt_set_isr(FuriHalInterruptIdTIM2, NULL, NULL);
+     furi_hal_bus_disable(FuriHalBusTIM2);
+     furi_hal_gpio_init(FAULT_PIN, GpioModeAnalog, GpioPullNo, GpioSpeedLow); // Hi-Z
+ }
+ 
+ bool fault_capture_pop(FaultCapture* fc, FaultEdge* out){
+     uint16_t tail = fc->tail;
+     if(tail == fc->head) return false;          // Empty
+     *out = fc->ring[tail];
+     fc->tail = (tail + 1) & (FAULT_CAPTURE_EDGES - 1); // Free the slot after copying
+     return true;
+ }
+ 
+ uint32_t fault_capture_now_us(void){
+     return LL_TIM_GetCounter(TIM2);
+ }
+ 
+ bool fault_capture_level(void){
+     return furi_hal_gpio_read(FAULT_PIN);
+ }
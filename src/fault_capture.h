@@ -0,0 +1,32 @@
+/*******************************************************************************************
+ * Expert Tool ICS — fault line input capture
+ * -----------------------------------------------------------------------------------------
+ * Timestamps both edges of the inverter fault/status line on header pin 5 (PB3) with
+ * TIM2 channel 2 input capture (1 µs tick, 32-bit, hardware filtered). The capture ISR
+ * only copies CCR2 and the pin level into a single-producer ring; the main loop drains
+ * it into the fault decoder, so edge timing is independent of GUI/scheduler latency.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include <stdbool.h>                            // bool
+ #include <stdint.h>                             // Fixed-width integers
+ 
+ #define FAULT_CAPTURE_EDGES 64                  // Ring capacity (power of two)
+ 
+ typedef struct {
+     uint32_t t_us;                              // Capture timestamp (TIM2 count, µs, wrapping)
+     bool level;                                 // Pin level right after the edge
+ } FaultEdge;
+ 
+ typedef struct {
+     FaultEdge ring[FAULT_CAPTURE_EDGES];        // Written by the ISR only
+     volatile uint16_t head;                     // Next slot the ISR writes
+     volatile uint16_t tail;                     // Next slot the main loop reads
+     volatile uint32_t dropped;                  // Edges lost to a full ring
+ } FaultCapture;
+ 
+ void fault_capture_start(FaultCapture* fc);     // Claim TIM2 + PB3, start capturing
+ void fault_capture_stop(FaultCapture* fc);      // Release TIM2, return PB3 to Hi-Z
+ bool fault_capture_pop(FaultCapture* fc, FaultEdge* out); // Oldest edge, false if empty
+ uint32_t fault_capture_now_us(void);            // Current TIM2 count (same timebase as edges)
+ bool fault_capture_level(void);                 // Current pin level
@@ -0,0 +1,83 @@
+/*******************************************************************************************
+ * Expert Tool ICS — inverter fault blink-code decoder (see fault_decoder.h)
+ *******************************************************************************************/
+ #include "fault_decoder.h"
+ 
+ #define FAULT_TENS_MAX 24                       // 24 * 10 + 9 = 249: below FAULT_CODE_NONE
+ 
+ static void group_clear(FaultDecoder* d){      // Forget a partial group
+     d->tens = 0;
+     d->units = 0;
+ }
+ 
+ static bool group_close(FaultDecoder* d){      // Group ended by a pause: emit a code
+     if(d->tens == 0 && d->units == 0) return false; // Nothing pending
+     uint8_t code = (uint8_t)(d->tens * 10U + d->units);
+     group_clear(d);
+ 
+     if(code == d->last_code){                   // Same as last time: more confidence
+         if(d->repeat < UINT8_MAX) d->repeat++;
+     } else {                                    // New pattern: start counting again
+         d->last_code = code;
+         d->repeat = 1;
+     }
+     if(d->repeat >= 2) d->confirmed = code;     // Seen twice in a row: trust it
+     return true;
+ }
+ 
+ void fault_decoder_init(FaultDecoder* d, const FaultProfile* p){
+     d->p = p;
+     d->level = !p->active_low;                  // Assume LED off until told otherwise
+     d->have_edge = false;
+     d->t_edge = 0;
+     group_clear(d);
+     d->last_code = FAULT_CODE_NONE;
+     d->repeat = 0;
+     d->confirmed = FAULT_CODE_NONE;
+     d->errors = 0;
+ }
+ 
+ bool fault_decoder_edge(FaultDecoder* d, uint32_t t_us, bool level){
+     const FaultProfile* p = d->p;
+     bool closed = false;
+ 
+     if(!d->have_edge || level == d->level){     // First edge or duplicate level: just sync
+         d->have_edge = true;
+         d->level = level;
+         d->t_edge = t_us;
+         return false;
+     }
+ 
+     uint32_t dur = t_us - d->t_edge;            // Length of the phase that just ended
+     bool was_lit = (d->level != p->active_low); // Phase that just ended was "LED on"
+ 
+     if(was_lit){                                // A blink ended: classify it
+         if(dur < p->on_min_us || dur > p->on_max_us){
+             group_clear(d);                     // Glitch or steady-on: not a code
+             d->errors++;
+         } else if(p->long_on_us && dur >= p->long_on_us){
+             if(d->tens < FAULT_TENS_MAX) d->tens++; // Long blink: tens digit
+             else { group_clear(d); d->errors++; } // Too many: lost sync
+         } else {
+             if(d->units < 9) d->units++;        // Short blink: units digit
+             else { group_clear(d); d->errors++; } // Too many: lost sync
+         }
+     } else {                                    // An off phase ended: gap or pause?
+         if(dur >= p->pause_min_us){
+             closed = group_close(d);            // Pause: previous group complete
+         } else if(dur > p->gap_max_us){
+             group_clear(d);                     // Neither gap nor pause: ambiguous
+             d->errors++;
+         }
+     }
+ 
+     d->level = level;
+     d->t_edge = t_us;
+     return closed;
+ }
+ 
+ bool fault_decoder_idle(FaultDecoder* d, uint32_t now_us){
+     if(!d->have_edge || fault_decoder_lit(d)) return false; // Only an off phase can be a pause
+     if(now_us - d->t_edge < d->p->pause_min_us) return false;
+     return group_close(d);                      // Closing twice is harmless (group now empty)
+ }
@@ -0,0 +1,57 @@
+/*******************************************************************************************
+ * Expert Tool ICS — inverter fault blink-code decoder
+ * -----------------------------------------------------------------------------------------
+ * Turns timestamped edges of an inverter status LED / status line into fault codes.
+ * A code is a group of blinks followed by a long pause; optional "long" blinks count
+ * tens, short blinks count units (e.g. 2 long + 3 short = 23). A code is confirmed
+ * once the same group has been seen twice in a row (the first group may be partial).
+ *
+ * Pure C with no Flipper dependencies so it can be built on the host and fed recorded
+ * pulse traces; the hardware side lives in fault_capture.c.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include <stdbool.h>                            // bool
+ #include <stdint.h>                             // Fixed-width integers
+ 
+ #define FAULT_CODE_NONE 0xFF                    // No code decoded / confirmed yet
+ 
+ typedef struct {
+     const char* name;                           // Shown on the fault screen
+     uint32_t on_min_us;                         // Shorter "on" pulses are glitches
+     uint32_t on_max_us;                         // Longer "on" pulses are not blinks (steady on)
+     uint32_t long_on_us;                        // On-time >= this counts as a tens blink (0 = units only)
+     uint32_t gap_max_us;                        // Longest "off" between blinks of one code
+     uint32_t pause_min_us;                      // Shortest "off" that ends a code
+     bool active_low;                            // Input level is LOW while the LED is lit
+ } FaultProfile;
+ 
+ typedef struct {
+     const FaultProfile* p;                      // Timing profile in use
+     bool level;                                 // Input level after the last edge
+     bool have_edge;                             // At least one edge seen
+     uint32_t t_edge;                            // Timestamp of the last edge (us, wrapping)
+ 
+     uint8_t tens;                               // Long blinks in the current group
+     uint8_t units;                              // Short blinks in the current group
+ 
+     uint8_t last_code;                          // Last complete group (FAULT_CODE_NONE if none)
+     uint8_t repeat;                             // Consecutive identical groups
+     uint8_t confirmed;                          // Confirmed code (FAULT_CODE_NONE if none)
+     uint16_t errors;                            // Pulses that fit no rule (noise, wrong profile)
+ } FaultDecoder;
+ 
+ void fault_decoder_init(FaultDecoder* d, const FaultProfile* p);
+ 
+ /* Feed one edge: `level` is the input level right after the edge at time t_us.
+  * Returns true if a group completed (last_code / confirmed may have changed). */
+ bool fault_decoder_edge(FaultDecoder* d, uint32_t t_us, bool level);
+ 
+ /* Call periodically: the pause after the final blink produces no edge, so the
+  * group is closed here once it has lasted pause_min_us. Same return as above. */
+ bool fault_decoder_idle(FaultDecoder* d, uint32_t now_us);
+ 
+ /* LED currently lit, according to the last edge */
+ static inline bool fault_decoder_lit(const FaultDecoder* d){
+     return d->have_edge && (d->level != d->p->active_low);
+ }
@@ -0,0 +1,97 @@
+/*******************************************************************************************
+ * Expert Tool ICS — packed help documents
+ * -----------------------------------------------------------------------------------------
+ * GENERATED by tools/help_pack.py from the src/help text files. Do not edit them here;
+ * edit the text files and re-run the script.
+ *******************************************************************************************/
+ 
+ #include "help_data.h"
+ 
+ static const char kHelpDictText[] =    // 36 entries, 240 bytes
+     " speed00 RPM ( wires as followPress BACK to st input 2 (A7)    -"
+     "> exact models as8 (GND)  ->files (family = ---- datasheet; driv"
+     "e0 HzConnect0 RPM:  Check theVEG, FMF)Built-in inverter art.(usu"
+     "ally reHz)LowMaxMidpros (VNE, s:te SD unitaddxpe";
+ static const uint16_t kHelpDictOfs[] = {
+     0, 6, 14, 30, 46, 53, 65, 81, 92, 108, 112, 123,
+     129, 133, 140, 145, 148, 157, 166, 174, 184, 188, 197, 199,
+     202, 205, 208, 211, 214, 216, 222, 224, 226, 229, 234, 237,
+     240,
+ };
+ const HelpDict kHelpDict = {.text = kHelpDictText, .ofs = kHelpDictOfs, .count = 36};
+ 
+ static const uint8_t kHelpEmbracoData[] = { // 38 lines, 455 -> 191 bytes
+     0x8D, 0x82, 0x9E, 0x85, 0x93, 0x2B, 0x95, 0x52, 0x45, 0x44, 0x20, 0x77, 0x69, 0x96, 0x29, 0x87,
+     0x93, 0x2D, 0x95, 0x57, 0x48, 0x49, 0x54, 0x45, 0x20, 0x77, 0x69, 0x96, 0x29, 0x4E, 0x6F, 0x9F,
+     0x3A, 0x54, 0x68, 0x69, 0x9C, 0x61, 0x70, 0x70, 0x20, 0x9B, 0x76, 0x69, 0x64, 0x65, 0x73, 0x33,
+     0x20, 0x9F, 0x73, 0x74, 0x80, 0x9E, 0x98, 0x80, 0x3A, 0x32, 0x30, 0x81, 0x56, 0x4E, 0x45, 0x29,
+     0x31, 0x38, 0x81, 0x91, 0x9A, 0x80, 0x3A, 0x33, 0x30, 0x30, 0x8E, 0x9D, 0x91, 0x99, 0x80, 0x3A,
+     0x34, 0x35, 0x30, 0x8E, 0x9D, 0x91, 0x45, 0x6D, 0x62, 0x72, 0x61, 0x63, 0x6F, 0x20, 0x63, 0x6F,
+     0x6D, 0x70, 0x96, 0x73, 0x73, 0x6F, 0x72, 0x73, 0x73, 0x75, 0x70, 0x70, 0x6F, 0x72, 0x74, 0x20,
+     0x6D, 0x61, 0x6E, 0x79, 0x80, 0x73, 0x77, 0x69, 0x74, 0x68, 0x20, 0x33, 0x8E, 0x20, 0x73, 0x9F,
+     0x70, 0x73, 0x2E, 0x89, 0x89, 0x89, 0x89, 0x41, 0x70, 0x70, 0x20, 0x63, 0x96, 0x61, 0x9F, 0x64,
+     0x20, 0x62, 0x79, 0x41, 0x64, 0x61, 0x6D, 0x20, 0x47, 0x72, 0x61, 0x79, 0x46, 0x6F, 0x75, 0x6E,
+     0x64, 0x65, 0x72, 0x20, 0x6F, 0x66, 0x45, 0xA3, 0x72, 0x74, 0x20, 0x48, 0x75, 0x62, 0x65, 0xA3,
+     0x72, 0x74, 0x68, 0x75, 0x62, 0x2E, 0x61, 0x70, 0x70, 0x89, 0x89, 0x89, 0x89, 0x83, 0x94,
+ };
+ static const uint16_t kHelpEmbracoLines[] = { // Start of each line + end
+     0, 3, 3, 6, 15, 18, 29, 29, 33, 47, 54, 54,
+     57, 64, 68, 68, 71, 75, 77, 77, 80, 84, 86, 86,
+     104, 118, 131, 131, 135, 135, 147, 156, 166, 174, 185, 185,
+     189, 189, 191,
+ };
+ const HelpDoc kHelpEmbraco = {.dict = &kHelpDict, .data = kHelpEmbracoData, .lines = kHelpEmbracoLines, .count = 38};
+ 
+ static const uint8_t kHelpLgData[] = { // 19 lines, 305 -> 100 bytes
+     0x8D, 0x82, 0x9E, 0x85, 0x8B, 0x84, 0x2B, 0x87, 0x8B, 0x84, 0x2D, 0x54, 0x68, 0x65, 0x8B, 0x20,
+     0x62, 0x6F, 0x61, 0x72, 0x64, 0x20, 0x65, 0xA3, 0x63, 0x74, 0x9C, 0x35, 0x56, 0x6C, 0x6F, 0x67,
+     0x69, 0x63, 0x3A, 0x20, 0x4F, 0x54, 0x47, 0x20, 0x35, 0x56, 0x20, 0x69, 0x9C, 0x73, 0x77, 0x69,
+     0x74, 0x63, 0x68, 0x65, 0x64, 0x6F, 0x6E, 0x20, 0x62, 0x65, 0x66, 0x6F, 0x96, 0x20, 0x61, 0x6E,
+     0x79, 0x20, 0x50, 0x57, 0x4D, 0x2E, 0x92, 0x80, 0x9E, 0x98, 0x8F, 0x34, 0x8C, 0x9A, 0x8F, 0x37,
+     0x8C, 0x99, 0x8F, 0x31, 0x30, 0x8C, 0x90, 0x8B, 0x8A, 0xA2, 0x86, 0xA0, 0x9B, 0x88, 0x6C, 0x67,
+     0x29, 0x2E, 0x83, 0x94,
+ };
+ static const uint16_t kHelpLgLines[] = { // Start of each line + end
+     0, 3, 3, 7, 11, 11, 29, 53, 70, 70, 73, 77,
+     81, 86, 86, 89, 92, 98, 98, 100,
+ };
+ const HelpDoc kHelpLg = {.dict = &kHelpDict, .data = kHelpLgData, .lines = kHelpLgLines, .count = 19};
+ 
+ static const uint8_t kHelpSamsungData[] = { // 1 lines, 15 -> 14 bytes
+     0x49, 0x6E, 0x20, 0x64, 0x65, 0x76, 0x65, 0x6C, 0x6F, 0x70, 0x6D, 0x65, 0x6E, 0x74,
+ };
+ static const uint16_t kHelpSamsungLines[] = { // Start of each line + end
+     0, 14,
+ };
+ const HelpDoc kHelpSamsung = {.dict = &kHelpDict, .data = kHelpSamsungData, .lines = kHelpSamsungLines, .count = 1};
+ 
+ static const uint8_t kHelpSecopData[] = { // 21 lines, 392 -> 154 bytes
+     0x8D, 0x82, 0x9E, 0x85, 0x80, 0x84, 0x2B, 0x87, 0x80, 0x84, 0x2D, 0x28, 0x66, 0x96, 0x71, 0x75,
+     0x65, 0x6E, 0x63, 0x79, 0x84, 0x6F, 0x66, 0x20, 0x74, 0x68, 0x65, 0x65, 0x6C, 0x65, 0x63, 0x74,
+     0x72, 0x6F, 0x6E, 0x69, 0x63, 0xA1, 0x29, 0x92, 0x80, 0x9C, 0x28, 0x33, 0x8E, 0x2F, 0x97, 0x3A,
+     0x98, 0x8F, 0x32, 0x30, 0x81, 0x36, 0x37, 0x20, 0x97, 0x9A, 0x8F, 0x33, 0x30, 0x81, 0x31, 0x30,
+     0x8C, 0x29, 0x99, 0x8F, 0x34, 0x35, 0x81, 0x31, 0x35, 0x8C, 0x29, 0x53, 0x74, 0x61, 0x74, 0x75,
+     0x9C, 0x4C, 0x45, 0x44, 0x3A, 0x20, 0x62, 0x6C, 0x69, 0x6E, 0x6B, 0x20, 0x63, 0x6F, 0x75, 0x6E,
+     0x74, 0x96, 0x70, 0x65, 0x61, 0x74, 0x9C, 0x61, 0x66, 0x9F, 0x72, 0x20, 0x61, 0x20, 0x70, 0x61,
+     0x75, 0x73, 0x65, 0x3B, 0x96, 0x61, 0x64, 0x20, 0x69, 0x74, 0x20, 0x6F, 0x6E, 0x20, 0x70, 0x69,
+     0x6E, 0x20, 0x35, 0x20, 0x28, 0x42, 0x33, 0x29, 0x2E, 0x90, 0xA1, 0x8A, 0xA2, 0x86, 0xA0, 0x9B,
+     0x88, 0x73, 0x65, 0x63, 0x6F, 0x70, 0x29, 0x2E, 0x83, 0x94,
+ };
+ static const uint16_t kHelpSecopLines[] = { // Start of each line + end
+     0, 3, 3, 7, 11, 27, 39, 39, 48, 57, 66, 75,
+     75, 97, 116, 137, 137, 140, 143, 152, 152, 154,
+ };
+ const HelpDoc kHelpSecop = {.dict = &kHelpDict, .data = kHelpSecopData, .lines = kHelpSecopLines, .count = 21};
+ 
+ static const uint8_t kHelpTecumsehData[] = { // 15 lines, 284 -> 66 bytes
+     0x8D, 0x82, 0x9E, 0x85, 0x80, 0x84, 0x2B, 0x87, 0x80, 0x84, 0x2D, 0x92, 0x80, 0x9C, 0x28, 0x33,
+     0x8E, 0x2F, 0x97, 0x3A, 0x98, 0x8F, 0x31, 0x38, 0x81, 0x36, 0x8C, 0x29, 0x9A, 0x8F, 0x33, 0x30,
+     0x81, 0x31, 0x30, 0x8C, 0x29, 0x99, 0x8F, 0x34, 0x30, 0x81, 0x31, 0x33, 0x33, 0x20, 0x97, 0x90,
+     0x8B, 0x8A, 0xA2, 0x86, 0xA0, 0x9B, 0x88, 0x9F, 0x63, 0x75, 0x6D, 0x73, 0x65, 0x68, 0x29, 0x2E,
+     0x83, 0x94,
+ };
+ static const uint16_t kHelpTecumsehLines[] = { // Start of each line + end
+     0, 3, 3, 7, 11, 11, 20, 28, 37, 47, 47, 50,
+     53, 64, 64, 66,
+ };
+ const HelpDoc kHelpTecumseh = {.dict = &kHelpDict, .data = kHelpTecumsehData, .lines = kHelpTecumsehLines, .count = 15};
@@ -0,0 +1,17 @@
+/*******************************************************************************************
+ * Expert Tool ICS — packed help documents
+ * -----------------------------------------------------------------------------------------
+ * GENERATED by tools/help_pack.py from the src/help text files. Do not edit them here;
+ * edit the text files and re-run the script.
+ *******************************************************************************************/
+ 
+ #pragma once
+ 
+ #include "help_text.h"
+ 
+ extern const HelpDict kHelpDict;             // Shared by every document
+ extern const HelpDoc kHelpEmbraco;
+ extern const HelpDoc kHelpLg;
+ extern const HelpDoc kHelpSamsung;
+ extern const HelpDoc kHelpSecop;
+ extern const HelpDoc kHelpTecumseh;
@@ -0,0 +1,164 @@
+/*******************************************************************************************
+ * Expert Tool ICS — help documents streamed from the SD card (see help_file.h)
+ *******************************************************************************************/
+ #include "help_file.h"
+ #include <stdio.h>                              // snprintf
+ #include <string.h>                             // memset, strcmp, strlen
+ 
+ #define HELP_INDEX_MAGIC   0x48534349U          // "ICSH"
+ #define HELP_INDEX_VERSION 1
+ #define HELP_FILE_MAX_LINES 0xFFFE              // count + 1 offsets must fit the uint16 line range
+ 
+ typedef struct {
+     uint32_t magic;                             // HELP_INDEX_MAGIC, written last
+     uint16_t version;                           // HELP_INDEX_VERSION
+     uint16_t count;                             // Lines; count + 1 offsets follow (last = end)
+     uint32_t src_size;                          // Source size when indexed
+     uint32_t src_ts;                            // Source timestamp when indexed
+ } HelpIndexHeader;
+ 
+ static bool read_exact(File* f, void* buf, size_t len){ return storage_file_read(f, buf, len) == len; }
+ static bool write_exact(File* f, const void* buf, size_t len){ return storage_file_write(f, buf, len) == len; }
+ 
+ /* ---------- Index ---------- */
+ static void index_path(char* out, size_t cap, const char* path){ // "x.txt" -> "x.idx"
+     size_t n = strlen(path);
+     if(n > 4 && strcmp(path + n - 4, ".txt") == 0) n -= 4;
+     snprintf(out, cap, "%.*s.idx", (int)n, path);
+ }
+ 
+ static bool index_valid(File* idx, const HelpIndexHeader* want, HelpIndexHeader* got){
+     return read_exact(idx, got, sizeof(*got)) && got->magic == HELP_INDEX_MAGIC &&
+            got->version == want->version && got->src_size == want->src_size &&
+            got->src_ts == want->src_ts;
+ }
+ 
+ /* One pass over the text: every '\n' starts a line. Offsets go out in batches of
+  * HELP_FILE_OFS through hf->ofs; hf->buf is the read chunk. */
+ static bool index_build(HelpFile* hf, const char* idx_path, HelpIndexHeader* h){
+     File* out = storage_file_alloc(hf->storage);
+     h->magic = 0;                               // A torn build never validates
+     h->count = 0;
+     bool ok = storage_file_open(out, idx_path, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+               write_exact(out, h, sizeof(*h)) && storage_file_seek(hf->text, 0, true);
+ 
+     uint32_t pos = 0;                           // File offset of hf->buf[0]
+     uint32_t last = 0;                          // Start of the line being scanned
+     uint32_t lines = 0;                         // Offsets emitted so far
+     uint8_t n = 0;                              // Offsets waiting in hf->ofs
+     hf->ofs[n++] = 0;
+     size_t got;
+     while(ok && (got = storage_file_read(hf->text, hf->buf, sizeof(hf->buf))) > 0){
+         for(size_t i = 0; i < got && lines < HELP_FILE_MAX_LINES; i++){
+             if(hf->buf[i] != '\n') continue;
+             last = pos + (uint32_t)i + 1;
+             hf->ofs[n++] = last;
+             lines++;
+             if(n == HELP_FILE_OFS){
+                 ok = write_exact(out, hf->ofs, n * sizeof(uint32_t));
+                 n = 0;
+             }
+         }
+         pos += (uint32_t)got;
+     }
+     if(ok && last < pos && lines < HELP_FILE_MAX_LINES){ // Last line without '\n'
+         hf->ofs[n++] = pos;
+         lines++;
+     }
+     ok = ok && (n == 0 || write_exact(out, hf->ofs, n * sizeof(uint32_t)));
+     h->magic = HELP_INDEX_MAGIC;
+     h->count = (uint16_t)lines;
+     ok = ok && storage_file_seek(out, 0, true) && write_exact(out, h, sizeof(*h));
+     storage_file_close(out);
+     storage_file_free(out);
+     if(!ok) storage_common_remove(hf->storage, idx_path);
+     return ok;
+ }
+ 
+ static bool ofs_load(HelpFile* hf, uint16_t line){ // Window holding ofs[line] and ofs[line + 1]
+     uint16_t first = (uint16_t)(line - line % HELP_FILE_OFS);
+     if(hf->ofs_first == first) return true;
+     uint32_t n = (uint32_t)hf->count + 1 - first; // Offsets left from first
+     if(n > HELP_FILE_OFS + 1) n = HELP_FILE_OFS + 1;
+     hf->ofs_first = HELP_FILE_NO_OFS;
+     if(!storage_file_seek(hf->index, sizeof(HelpIndexHeader) + first * sizeof(uint32_t), true) ||
+        !read_exact(hf->index, hf->ofs, n * sizeof(uint32_t))) return false;
+     hf->ofs_first = first;
+     return true;
+ }
+ 
+ /* ---------- Public API ---------- */
+ bool help_file_open(HelpFile* hf, Storage* storage, const char* path){
+     memset(hf, 0, sizeof(*hf));
+     hf->storage = storage;
+     hf->ofs_first = HELP_FILE_NO_OFS;
+     FileInfo fi;
+     if(storage_common_stat(storage, path, &fi) != FSE_OK || (fi.flags & FSF_DIRECTORY)) return false;
+ 
+     HelpIndexHeader want = {.version = HELP_INDEX_VERSION, .src_size = (uint32_t)fi.size};
+     storage_common_timestamp(storage, path, &want.src_ts); // Catches same-size edits
+     char idx_path[HELP_FILE_PATH_LEN];
+     index_path(idx_path, sizeof(idx_path), path);
+ 
+     hf->text = storage_file_alloc(storage);
+     hf->index = storage_file_alloc(storage);
+     bool ok = storage_file_open(hf->text, path, FSAM_READ, FSOM_OPEN_EXISTING);
+     HelpIndexHeader h;
+     if(ok && !(storage_file_open(hf->index, idx_path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+                index_valid(hf->index, &want, &h))){ // Missing / stale: rebuild once
+         storage_file_close(hf->index);
+         h = want;
+         ok = index_build(hf, idx_path, &h) &&
+              storage_file_open(hf->index, idx_path, FSAM_READ, FSOM_OPEN_EXISTING);
+     }
+     if(!ok){
+         help_file_close(hf);
+         return false;
+     }
+     hf->count = h.count;
+     hf->buf_len = 0;                            // buf was the build chunk: not file text here
+     return true;
+ }
+ 
+ void help_file_close(HelpFile* hf){
+     if(hf->text){
+         storage_file_close(hf->text);
+         storage_file_free(hf->text);
+     }
+     if(hf->index){
+         storage_file_close(hf->index);
+         storage_file_free(hf->index);
+     }
+     hf->text = hf->index = NULL;
+     hf->count = 0;
+ }
+ 
+ size_t help_file_line(HelpFile* hf, uint16_t line, char* out, size_t cap){
+     if(cap == 0) return 0;
+     out[0] = '\0';
+     if(line >= hf->count || !ofs_load(hf, line)) return 0;
+     uint32_t start = hf->ofs[line - hf->ofs_first];
+     uint32_t end = hf->ofs[line - hf->ofs_first + 1];
+     uint32_t need = end - start;                // Only what fits the output is read
+     if(need > cap - 1) need = (uint32_t)(cap - 1);
+ 
+     if(start < hf->buf_pos || start + need > hf->buf_pos + hf->buf_len){ // Outside the block
+         uint32_t pos = start;                   // Scrolling down: block starts at the line
+         if(start < hf->buf_pos){                // Scrolling up: block ends at the line
+             pos = (start + need > HELP_FILE_BLOCK) ? start + need - HELP_FILE_BLOCK : 0;
+         }
+         hf->buf_len = 0;
+         if(!storage_file_seek(hf->text, pos, true)) return 0;
+         hf->buf_pos = pos;
+         hf->buf_len = (uint16_t)storage_file_read(hf->text, hf->buf, sizeof(hf->buf));
+         if(start + need > hf->buf_pos + hf->buf_len) return 0; // Short read: file changed
+     }
+ 
+     const char* p = hf->buf + (start - hf->buf_pos);
+     size_t n = 0;
+     for(; n < need && p[n] != '\n' && p[n] != '\r'; n++){
+         out[n] = (p[n] == '\t') ? ' ' : p[n];   // One glyph per byte on screen
+     }
+     out[n] = '\0';
+     return n;
+ }
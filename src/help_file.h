@@ -0,0 +1,40 @@
+/*******************************************************************************************
+ * Expert Tool ICS — help documents streamed from the SD card
+ * -----------------------------------------------------------------------------------------
+ * A plain text file, one screen line per text line. Next to it ("<name>.idx") sits an
+ * index of line start offsets, built on the first open and rebuilt whenever the text's
+ * size or timestamp changes. Only a window of HELP_FILE_OFS offsets and one read-ahead
+ * block of text are held in RAM, so a 2 000-line guide costs the same as a 40-line one:
+ * one seek + read per block, and nothing when scrolling inside the block.
+ *
+ * Runs on the main thread (file access); the help screen draws from the line cache.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include <storage/storage.h>                    // SD access
+ #include <stdbool.h>                            // bool
+ #include <stddef.h>                             // size_t
+ #include <stdint.h>                             // Fixed-width integers
+ 
+ #define HELP_FILE_BLOCK    512                  // Text read-ahead, bytes
+ #define HELP_FILE_OFS      32                   // Line offsets read per index access
+ #define HELP_FILE_PATH_LEN 128
+ #define HELP_FILE_NO_OFS   0xFFFF               // ofs[] holds nothing yet
+ 
+ typedef struct {
+     Storage* storage;
+     File* text;                                 // Source, open while the help screen is
+     File* index;                                // Its line index, open alongside
+     uint16_t count;                             // Lines in the document
+     uint16_t ofs_first;                         // Line of ofs[0] (HELP_FILE_NO_OFS = none)
+     uint32_t ofs[HELP_FILE_OFS + 1];            // Line starts ofs_first .. ofs_first + OFS
+     uint32_t buf_pos;                           // File offset of buf[0]
+     uint16_t buf_len;                           // Valid bytes in buf
+     char buf[HELP_FILE_BLOCK];                  // Read-ahead block (index build: read chunk)
+ } HelpFile;
+ 
+ /* Opens path and its index, building the index if missing or stale. false: no such file
+  * (or the card is unusable) and nothing is left open. */
+ bool help_file_open(HelpFile* hf, Storage* storage, const char* path);
+ void help_file_close(HelpFile* hf);
+ size_t help_file_line(HelpFile* hf, uint16_t line, char* out, size_t cap); // "" past the end
@@ -0,0 +1,66 @@
+/*******************************************************************************************
+ * Expert Tool ICS — compressed help text (see help_text.h)
+ *******************************************************************************************/
+ #include "help_text.h"
+ #include <string.h>                             // strncpy
+ 
+ size_t help_text_line(const HelpDoc* doc, uint16_t line, char* out, size_t cap){
+     size_t n = 0;
+     if(line < doc->count && cap > 0){
+         const uint8_t* p = doc->data + doc->lines[line];
+         const uint8_t* end = doc->data + doc->lines[line + 1];
+         while(p < end){
+             uint8_t b = *p++;
+             if(b < 0x80){                       // Literal character
+                 if(n + 1 < cap) out[n++] = (char)b;
+                 continue;
+             }
+             uint8_t w = (uint8_t)(b & 0x7F);    // Dictionary entry
+             if(w >= doc->dict->count) continue; // Corrupt data: skip, never overrun
+             for(uint16_t i = doc->dict->ofs[w]; i < doc->dict->ofs[w + 1] && n + 1 < cap; i++){
+                 out[n++] = doc->dict->text[i];
+             }
+         }
+     }
+     if(cap > 0) out[n] = '\0';
+     return n;
+ }
+ 
+ /* Orders the text copy against the key stores: volatile alone does not stop the compiler
+  * moving the plain strncpy() stores across them. One core, so no hardware barrier. */
+ #define HELP_CACHE_BARRIER() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+ 
+ void help_cache_reset(HelpCache* c){
+     c->src = NULL;
+     for(uint8_t i = 0; i < HELP_CACHE_LINES; i++) c->key[i] = HELP_CACHE_EMPTY;
+ }
+ 
+ const char* help_cache_find(const HelpCache* c, const void* src, uint16_t line){
+     uint8_t slot = (uint8_t)(line & (HELP_CACHE_LINES - 1));
+     return (c->src == src && c->key[slot] == line) ? c->text[slot] : NULL;
+ }
+ 
+ /* The key is cleared while the text changes, so a reader on another thread sees a miss,
+  * never half a line. The last byte of a slot stays NUL either way. */
+ void help_cache_store(HelpCache* c, const void* src, uint16_t line, const char* text){
+     if(c->src != src){                          // Other document: start over
+         help_cache_reset(c);
+         c->src = src;
+     }
+     uint8_t slot = (uint8_t)(line & (HELP_CACHE_LINES - 1));
+     c->key[slot] = HELP_CACHE_EMPTY;
+     HELP_CACHE_BARRIER();
+     strncpy(c->text[slot], text, HELP_LINE_MAX - 1);
+     c->text[slot][HELP_LINE_MAX - 1] = '\0';
+     HELP_CACHE_BARRIER();
+     c->key[slot] = line;
+ }
+ 
+ const char* help_cache_line(HelpCache* c, const HelpDoc* doc, uint16_t line){
+     const char* hit = help_cache_find(c, doc, line);
+     if(hit) return hit;
+     char text[HELP_LINE_MAX];                   // Miss: decode, then fill the slot
+     help_text_line(doc, line, text, sizeof(text));
+     help_cache_store(c, doc, line, text);
+     return help_cache_find(c, doc, line);
+ }
@@ -0,0 +1,46 @@
+/*******************************************************************************************
+ * Expert Tool ICS — compressed help text
+ * -----------------------------------------------------------------------------------------
+ * Help documents are stored in flash packed against one shared static dictionary
+ * (tools/help_pack.py, sources in the src/help text files). A byte below 0x80 is a literal
+ * character; 0x80 + n stands for dictionary entry n. Lines are addressed through an
+ * offset table, so any single line decodes on its own.
+ *
+ * The help screen reads lines through a small direct-mapped cache keyed by line number:
+ * with more slots than visible lines, scrolling by one line decodes exactly one line,
+ * and RAM stays the same however long the documents grow. The same cache also holds
+ * lines read from SD help files (help_file.h); its owner key is then the HelpFile.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include <stddef.h>                             // size_t
+ #include <stdint.h>                             // Fixed-width integers
+ 
+ #define HELP_LINE_MAX    32                     // Decoded line incl. NUL (tools/help_pack.py)
+ #define HELP_CACHE_LINES 8                      // Power of two, > lines visible on screen
+ #define HELP_CACHE_EMPTY 0xFFFF
+ 
+ typedef struct {
+     const char* text;                           // All entries back to back
+     const uint16_t* ofs;                        // Entry n = text[ofs[n] .. ofs[n + 1])
+     uint8_t count;
+ } HelpDict;
+ 
+ typedef struct {
+     const HelpDict* dict;                       // Shared dictionary
+     const uint8_t* data;                        // Packed lines back to back
+     const uint16_t* lines;                      // Line n = data[lines[n] .. lines[n + 1])
+     uint16_t count;                             // Lines in the document
+ } HelpDoc;
+ 
+ typedef struct {
+     const void* volatile src;                   // Document the slots belong to (HelpDoc / HelpFile)
+     volatile uint16_t key[HELP_CACHE_LINES];    // Line held by each slot (HELP_CACHE_EMPTY = none)
+     char text[HELP_CACHE_LINES][HELP_LINE_MAX]; // Decoded lines
+ } HelpCache;
+ 
+ size_t help_text_line(const HelpDoc* doc, uint16_t line, char* out, size_t cap); // Decode one line
+ void help_cache_reset(HelpCache* c);            // Drop all slots
+ const char* help_cache_find(const HelpCache* c, const void* src, uint16_t line); // NULL on a miss
+ void help_cache_store(HelpCache* c, const void* src, uint16_t line, const char* text); // Fill a slot
+ const char* help_cache_line(HelpCache* c, const HelpDoc* doc, uint16_t line); // Cached decode
@@ -0,0 +1,82 @@
+/*******************************************************************************************
+ * Expert Tool ICS — inverter families (see inverter_family.h)
+ *******************************************************************************************/
+ #include "inverter_family.h"
+ #include "help_data.h"                          // kHelp* documents
+ #include <string.h>                             // strcmp
+ 
+ /* Mode rows: label, PWM Hz, LED blink Hz, reserved, auto-off s. Row 0 is always Stand by.
+  * Frequency-input units run at 30 RPM per Hz; exact models belong in SD profiles. */
+ const InverterFamily kInverterFamilies[InvCount] = {
+     /* Embraco defaults — ONLY ONE CHANGE: Max 160 -> 150 (see last entry) */
+     [InvEmbraco] = {.key = "embraco",
+      .profile = {.name = "Embraco", .family = InvEmbraco, .needs_5v = 0, .duty_pct = 50,
+       .mode_count = 4, .modes = {
+          {"Stand by",    0, 0, 0,   0},          // 0: No PWM, pin forced LOW, no timer
+          {"Low speed",  55, 1, 0, 120},          // 1: 55 Hz PWM, LED 1 Hz, 2 minutes limit
+          {"Mid speed", 100, 2, 0,  60},          // 2: 100 Hz PWM, LED 2 Hz, 1 minute limit
+          {"Max speed", 150, 4, 0,  30},          // 3: 150 Hz PWM, LED 4 Hz, 30 seconds limit  // CHANGED
+      }},
+      .fault = {.name = "Embraco", .on_min_us = 150000, .on_max_us = 800000, .long_on_us = 0,
+                .gap_max_us = 1000000, .pause_min_us = 2000000, .active_low = true},
+      .help = &kHelpEmbraco},
+     /* Samsung: same rows and limits, own frequencies, needs the OTG 5V rail */
+     [InvSamsung] = {.key = "samsung",
+      .profile = {.name = "Samsung", .family = InvSamsung, .needs_5v = 1, .duty_pct = 50,
+       .mode_count = 4, .modes = {
+          {"Stand by",    0, 0, 0,   0},
+          {"Low speed",   5, 1, 0, 120},          // Low  = 5 Hz
+          {"Mid speed", 400, 2, 0,  60},          // Mid  = 400 Hz
+          {"Max speed", 800, 4, 0,  30},          // Max  = 800 Hz
+      }},
+      .fault = {.name = "Samsung", .on_min_us = 150000, .on_max_us = 2000000, .long_on_us = 900000,
+                .gap_max_us = 1000000, .pause_min_us = 2500000, .active_low = true},
+      .help = &kHelpSamsung},
+     /* Secop / Danfoss: 2000 / 3000 / 4500 RPM */
+     [InvSecop] = {.key = "secop",
+      .profile = {.name = "Secop", .family = InvSecop, .needs_5v = 0, .duty_pct = 50,
+       .mode_count = 4, .modes = {
+          {"Stand by",    0, 0, 0,   0},
+          {"Low speed",  67, 1, 0, 120},
+          {"Mid speed", 100, 2, 0,  60},
+          {"Max speed", 150, 4, 0,  30},
+      }},
+      .fault = {.name = "Secop", .on_min_us = 150000, .on_max_us = 800000, .long_on_us = 0,
+                .gap_max_us = 1000000, .pause_min_us = 2500000, .active_low = true},
+      .help = &kHelpSecop},
+     /* Tecumseh: 1800 / 3000 / 4000 RPM */
+     [InvTecumseh] = {.key = "tecumseh",
+      .profile = {.name = "Tecumseh", .family = InvTecumseh, .needs_5v = 0, .duty_pct = 50,
+       .mode_count = 4, .modes = {
+          {"Stand by",    0, 0, 0,   0},
+          {"Low speed",  60, 1, 0, 120},
+          {"Mid speed", 100, 2, 0,  60},
+          {"Max speed", 133, 4, 0,  30},
+      }},
+      .fault = {.name = "Tecumseh", .on_min_us = 150000, .on_max_us = 800000, .long_on_us = 0,
+                .gap_max_us = 1000000, .pause_min_us = 2000000, .active_low = true},
+      .help = &kHelpTecumseh},
+     /* LG: 5V logic drive input, like Samsung */
+     [InvLg] = {.key = "lg",
+      .profile = {.name = "LG", .family = InvLg, .needs_5v = 1, .duty_pct = 50,
+       .mode_count = 4, .modes = {
+          {"Stand by",    0, 0, 0,   0},
+          {"Low speed",  40, 1, 0, 120},
+          {"Mid speed",  70, 2, 0,  60},
+          {"Max speed", 100, 4, 0,  30},
+      }},
+      .fault = {.name = "LG", .on_min_us = 150000, .on_max_us = 2000000, .long_on_us = 900000,
+                .gap_max_us = 1000000, .pause_min_us = 2500000, .active_low = true},
+      .help = &kHelpLg},
+ };
+ 
+ const InverterFamily* inverter_family_get(uint8_t id){
+     return &kInverterFamilies[(id < InvCount) ? id : InvEmbraco];
+ }
+ 
+ int8_t inverter_family_find(const char* key){
+     for(uint8_t i = 0; i < InvCount; i++){
+         if(strcmp(key, kInverterFamilies[i].key) == 0) return (int8_t)i;
+     }
+     return -1;
+ }
@@ -0,0 +1,38 @@
+/*******************************************************************************************
+ * Expert Tool ICS — inverter families
+ * -----------------------------------------------------------------------------------------
+ * One const descriptor per compressor brand: the built-in profile (speeds, duty, LED
+ * pattern, auto-off, 5V requirement), the timing of its fault-blink output and its help
+ * text. The app keeps a pointer to the descriptor of the selected profile and reads
+ * everything brand-specific through it, so supporting another brand means adding one
+ * enum value, one table entry and one src/help text file; no code paths change.
+ *
+ * SD profiles name their family by key ("family = secop"); the key is also the name of
+ * the family's SD help file.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include "profile_pack.h"                       // Profile
+ #include "fault_decoder.h"                      // FaultProfile
+ #include "help_text.h"                          // HelpDoc
+ 
+ typedef enum {
+     InvEmbraco = 0,                             // Embraco VNE / VEG / FMF (frequency input)
+     InvSamsung,                                 // Samsung drive board (requires OTG 5V)
+     InvSecop,                                   // Secop / Danfoss electronic units (frequency input)
+     InvTecumseh,                                // Tecumseh variable-speed drives (frequency input)
+     InvLg,                                      // LG inverter drive boards (requires OTG 5V)
+     InvCount,
+ } InverterId;
+ 
+ typedef struct {
+     const char* key;                            // "family =" keyword and SD help file name
+     Profile profile;                            // Built-in row (family = own InverterId)
+     FaultProfile fault;                         // Status-output blink timing
+     const HelpDoc* help;                        // Built-in help text
+ } InverterFamily;
+ 
+ extern const InverterFamily kInverterFamilies[InvCount]; // Indexed by InverterId
+ 
+ const InverterFamily* inverter_family_get(uint8_t id); // Out of range -> Embraco
+ int8_t inverter_family_find(const char* key);  // InverterId, -1 if unknown
@@ -0,0 +1,184 @@
+/*******************************************************************************************
+ * Expert Tool ICS — load-profile playback streamed from the SD card (see load_play.h)
+ *******************************************************************************************/
+ #include "load_play.h"
+ #include <string.h>                             // memset, strchr
+ 
+ #define LOAD_PLAY_MAX_S  4000000U               // ~46 days: t_ms stays inside 32 bits
+ #define LOAD_PLAY_DAY_MS 86400000U
+ 
+ typedef enum {
+     LineBlank,                                  // Empty or comment only
+     LinePoint,                                  // One breakpoint
+     LineBad,                                    // Anything else (header, typo, time going back)
+ } LineKind;
+ 
+ /* ---------- Line parser ---------- */
+ static bool is_blank(char ch){ return ch == ' ' || ch == '\t' || ch == '\r'; }
+ 
+ static bool parse_uint(const char** p, uint32_t* v){ // At least one digit, at most 9
+     uint32_t n = 0;
+     uint8_t digits = 0;
+     while(**p >= '0' && **p <= '9'){
+         if(++digits > 9) return false;
+         n = n * 10U + (uint32_t)(**p - '0');
+         (*p)++;
+     }
+     *v = n;
+     return digits > 0;
+ }
+ 
+ static bool parse_time(const char** p, uint32_t* ms, bool* clock){ // s | m:s | h:m:s, [.fff]
+     uint32_t part[3];
+     uint8_t n = 0;
+     for(;;){
+         if(n == 3 || !parse_uint(p, &part[n])) return false;
+         if(n > 0 && part[n] >= 60) return false; // Minutes / seconds field
+         n++;
+         if(**p != ':') break;
+         (*p)++;
+     }
+     uint32_t secs = part[0];
+     for(uint8_t i = 1; i < n; i++) secs = secs * 60U + part[i];
+     if(secs > LOAD_PLAY_MAX_S) return false;
+ 
+     uint32_t frac = 0;
+     if(**p == '.'){                             // Milliseconds; further digits are ignored
+         (*p)++;
+         uint32_t scale = 100;
+         for(; **p >= '0' && **p <= '9'; (*p)++){
+             frac += (uint32_t)(**p - '0') * scale;
+             scale /= 10;
+         }
+     }
+     *ms = secs * 1000U + frac;
+     *clock = (n > 1);
+     return true;
+ }
+ 
+ static LineKind parse_line(LoadPlay* lp, char* s, LoadPoint* out){
+     char* hash = strchr(s, '#');
+     if(hash) *hash = '\0';
+     while(is_blank(*s)) s++;
+     if(*s == '\0') return LineBlank;
+ 
+     const char* p = s;
+     uint32_t t, hz;
+     bool clock;
+     if(!parse_time(&p, &t, &clock)) return LineBad;
+     const char* sep = p;                        // Time and speed need a separator
+     while(is_blank(*p)) p++;
+     if(*p == ',' || *p == ';') p++;
+     while(is_blank(*p)) p++;
+     if(p == sep || !parse_uint(&p, &hz) || hz > 0xFFFF) return LineBad;
+     if(*p != '\0' && *p != ',' && *p != ';' && !is_blank(*p)) return LineBad; // Further columns are ignored
+ 
+     if(!lp->started){                           // First breakpoint is t = 0
+         lp->started = true;
+         lp->clock = clock;
+         lp->t_first = t;
+     }
+     uint32_t abs = t + lp->t_day;
+     if(abs < lp->t_first || abs - lp->t_first < lp->t_last){ // Back in time: only a clock log
+         if(!lp->clock || !clock) return LineBad; // that passed midnight (jump of over 12 h)
+         if(lp->t_first + lp->t_last - abs < LOAD_PLAY_DAY_MS / 2) return LineBad;
+         abs += LOAD_PLAY_DAY_MS;
+         lp->t_day += LOAD_PLAY_DAY_MS;
+     }
+     if(hz > lp->max_hz){
+         hz = lp->max_hz;
+         lp->clamped++;
+     }
+     out->t_ms = abs - lp->t_first;
+     out->freq_hz = (uint16_t)hz;
+     out->reserved = 0;
+     lp->t_last = out->t_ms;
+     return LinePoint;
+ }
+ 
+ /* ---------- File reading ---------- */
+ /* Assembles the next line in lp->line from the chunk buffer. false at end of file. */
+ static bool next_line(LoadPlay* lp){
+     lp->line_len = 0;
+     lp->line_long = false;
+     for(;;){
+         if(lp->chunk_pos == lp->chunk_len){
+             lp->chunk_pos = 0;
+             lp->chunk_len = (uint8_t)storage_file_read(lp->file, lp->chunk, sizeof(lp->chunk));
+             if(lp->chunk_len == 0) break;       // End of file (or read error)
+         }
+         char ch = lp->chunk[lp->chunk_pos++];
+         if(ch == '\n') break;
+         if(lp->line_len + 1 < LOAD_PLAY_LINE) lp->line[lp->line_len++] = ch;
+         else lp->line_long = true;
+     }
+     lp->line[lp->line_len] = '\0';
+     return lp->chunk_len > 0 || lp->line_len > 0 || lp->line_long; // Last line may lack '\n'
+ }
+ 
+ static void fill_block(LoadPlay* lp, uint8_t b){
+     uint8_t n = 0;
+     while(n < LOAD_PLAY_BLOCK && next_line(lp)){
+         LineKind kind = lp->line_long ? LineBad : parse_line(lp, lp->line, &lp->block[b][n]);
+         if(kind == LinePoint){
+             n++;
+             lp->points++;
+         } else if(kind == LineBad){
+             lp->skipped++;
+         }
+     }
+     lp->len[b] = n;                             // Publish the half first,
+     if(n < LOAD_PLAY_BLOCK) lp->eof = true;     // then the end of the file
+ }
+ 
+ /* ---------- Public API ---------- */
+ bool load_play_open(LoadPlay* lp, Storage* storage, const char* path, uint16_t max_hz){
+     memset(lp, 0, sizeof(*lp));
+     lp->storage = storage;
+     lp->max_hz = max_hz;
+     lp->file = storage_file_alloc(storage);
+     if(!storage_file_open(lp->file, path, FSAM_READ, FSOM_OPEN_EXISTING)){
+         load_play_close(lp);
+         return false;
+     }
+     load_play_fill(lp);
+     if(lp->len[0] == 0){                        // Nothing playable
+         load_play_close(lp);
+         return false;
+     }
+     return true;
+ }
+ 
+ void load_play_close(LoadPlay* lp){
+     if(lp->file){
+         storage_file_close(lp->file);
+         storage_file_free(lp->file);
+     }
+     lp->file = NULL;
+ }
+ 
+ bool load_play_fill(LoadPlay* lp){
+     bool did = false;
+     while(lp->file && !lp->eof && lp->len[lp->fill] == 0){ // At most both halves
+         fill_block(lp, lp->fill);
+         lp->fill ^= 1;
+         did = true;
+     }
+     return did;
+ }
+ 
+ const LoadPoint* load_play_peek(const LoadPlay* lp){
+     return lp->len[lp->cur] ? &lp->block[lp->cur][lp->idx] : NULL;
+ }
+ 
+ void load_play_next(LoadPlay* lp){
+     if(lp->len[lp->cur] == 0) return;
+     if(++lp->idx < lp->len[lp->cur]) return;
+     lp->idx = 0;                                // Half used up: hand it back to the main loop
+     lp->len[lp->cur] = 0;
+     lp->cur ^= 1;
+ }
+ 
+ bool load_play_done(const LoadPlay* lp){
+     return lp->eof && lp->len[0] == 0 && lp->len[1] == 0;
+ }
@@ -0,0 +1,71 @@
+/*******************************************************************************************
+ * Expert Tool ICS — load-profile playback streamed from the SD card
+ * -----------------------------------------------------------------------------------------
+ * Replays a logged demand curve (speed versus time, e.g. 24 h from a fridge controller).
+ * The text file is parsed a block of breakpoints at a time into one half of a double
+ * buffer while the scheduler timer consumes the other half, so a file of any length plays
+ * in the same ~1.3 KB of RAM.
+ *
+ * File format, one breakpoint per line ('#' starts a comment, other lines are skipped):
+ *     time, Hz                    time = seconds[.fraction] or [hh:]mm:ss[.fraction]
+ * Times are relative to the first breakpoint and must not go backwards; clock times may
+ * pass midnight once per day. The speed holds until the next breakpoint; 0 Hz stops PWM.
+ *
+ * Threads: load_play_fill() runs on the main thread (file access) and only writes blocks
+ * whose len is 0; peek/next run on the scheduler and set len back to 0 once a block is
+ * used up. Each block has exactly one writer at a time.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include <storage/storage.h>                    // SD access
+ #include <stdbool.h>                            // bool
+ #include <stdint.h>                             // Fixed-width integers
+ 
+ #define LOAD_PLAY_BLOCK 64                      // Breakpoints per buffer half
+ #define LOAD_PLAY_CHUNK 128                     // File bytes per read
+ #define LOAD_PLAY_LINE  48                      // Longest line kept (longer lines are skipped)
+ 
+ typedef struct {
+     uint32_t t_ms;                              // Time from the first breakpoint
+     uint16_t freq_hz;                           // Speed from here on (0 = stop)
+     uint16_t reserved;
+ } LoadPoint;
+ 
+ typedef struct {
+     Storage* storage;
+     File* file;                                 // Open while playing
+     uint16_t max_hz;                            // Faster breakpoints are clamped to this
+ 
+     LoadPoint block[2][LOAD_PLAY_BLOCK];        // Double buffer
+     volatile uint8_t len[2];                    // Points in each half (0 = free for the main loop)
+     volatile bool eof;                          // Whole file parsed (set after the last len)
+     uint8_t fill;                               // Half the main loop fills next
+     uint8_t cur;                                // Half the scheduler reads
+     uint8_t idx;                                // Next point in block[cur]
+ 
+     bool started;                               // First breakpoint seen (t_first valid)
+     bool clock;                                 // Times are clock times (may wrap at midnight)
+     uint32_t t_first;                           // Time of the first breakpoint, file ms
+     uint32_t t_day;                             // Midnight wraps so far, in ms
+     uint32_t t_last;                            // Last accepted relative time
+ 
+     uint32_t points;                            // Breakpoints parsed so far
+     uint16_t skipped;                           // Lines that are not a breakpoint
+     uint16_t clamped;                           // Breakpoints above max_hz
+ 
+     char chunk[LOAD_PLAY_CHUNK];                // Read buffer
+     uint8_t chunk_pos;                          // Next unparsed byte in chunk
+     uint8_t chunk_len;                          // Valid bytes in chunk
+     char line[LOAD_PLAY_LINE];                  // Line being assembled across chunks
+     uint8_t line_len;
+     bool line_long;                             // Current line overflowed: skip it
+ } LoadPlay;
+ 
+ /* Opens path and buffers the first breakpoints. false: no such file or not one usable
+  * breakpoint in it; nothing is left open. */
+ bool load_play_open(LoadPlay* lp, Storage* storage, const char* path, uint16_t max_hz);
+ void load_play_close(LoadPlay* lp);
+ bool load_play_fill(LoadPlay* lp);              // Main loop: parse into free halves (true = did)
+ const LoadPoint* load_play_peek(const LoadPlay* lp); // Scheduler: next breakpoint (NULL = none buffered)
+ void load_play_next(LoadPlay* lp);              // Scheduler: consume the peeked breakpoint
+ bool load_play_done(const LoadPlay* lp);        // Everything parsed and consumed
@@ -0,0 +1,207 @@
+/*******************************************************************************************
+ * Expert Tool ICS — logic-analyzer capture (see logic_capture.h)
+ *******************************************************************************************/
+ #include "logic_capture.h"
+ #include <furi_hal.h>                           // GPIO, bus clocks, interrupt table
+ #include <stm32wbxx_ll_tim.h>                   // TIM2 as the sample clock
+ #include <stm32wbxx_ll_dma.h>                   // DMA2 channel 6 + DMAMUX routing
+ #include <stdio.h>                              // snprintf
+ #include <string.h>                             // memset
+ 
+ #define LOGIC_DMA    DMA2
+ #define LOGIC_DMA_CH LL_DMA_CHANNEL_6           // Channel 5 belongs to adc_stream
+ #define LOGIC_TIM_HZ 64000000U                  // TIM2 kernel clock, prescaler 1
+ #define LOGIC_MASK   ((1U << 7) | (1U << 6) | (1U << 4)) // PA7, PA6, PA4 in GPIOA->IDR
+ 
+ static const struct {
+     uint8_t bit;                                // GPIOA bit
+     const char* name;                           // VCD signal name
+ } kLogicPins[LOGIC_CHANNELS] = {
+     {7, "pin2_A7"},
+     {6, "pin3_A6"},
+     {4, "pin4_A4"},
+ };
+ 
+ static inline uint8_t logic_pack(uint16_t idr){ // Masked IDR -> 3 level bits (channel order)
+     return (uint8_t)(((idr >> 7) & 1U) | (((idr >> 6) & 1U) << 1) | (((idr >> 4) & 1U) << 2));
+ }
+ 
+ static void logic_halt(void){                  // Stop the sample clock and the DMA
+     LL_TIM_DisableCounter(TIM2);
+     LL_TIM_DisableDMAReq_UPDATE(TIM2);
+     LL_DMA_DisableChannel(LOGIC_DMA, LOGIC_DMA_CH);
+ }
+ 
+ static bool logic_emit(LogicCapture* lc){      // Close the open run; false when full
+     if(lc->n_runs >= LOGIC_RUNS){
+         lc->full = true;
+         return false;
+     }
+     lc->runs[lc->n_runs++] = (lc->cur_run << 8) | logic_pack(lc->cur);
+     return true;
+ }
+ 
+ static void logic_encode(LogicCapture* lc, const uint16_t* x){ // One DMA half, in place
+     uint16_t cur = lc->cur;
+     uint32_t run = lc->cur_run;
+     for(size_t i = 0; i < LOGIC_BLOCK; i++){
+         uint16_t v = x[i] & LOGIC_MASK;         // Compare masked words; pack only on change
+         if(v == cur && run < LOGIC_RUN_MAX){
+             run++;
+             continue;
+         }
+         lc->cur = cur;
+         lc->cur_run = run;
+         if(!logic_emit(lc)){                    // Out of space: stop here
+             lc->samples += i;
+             lc->cur_run = 0;
+             logic_halt();
+             return;
+         }
+         cur = v;
+         run = 1;
+     }
+     lc->cur = cur;
+     lc->cur_run = run;
+     lc->samples += LOGIC_BLOCK;
+ }
+ 
+ static void logic_isr(void* ctx){              // DMA2 CH6: a half of snapshots is ready
+     LogicCapture* lc = ctx;
+     if(LL_DMA_IsActiveFlag_TE6(LOGIC_DMA)){
+         LL_DMA_ClearFlag_TE6(LOGIC_DMA);
+         lc->errors++;
+     }
+     if(LL_DMA_IsActiveFlag_HT6(LOGIC_DMA)){
+         LL_DMA_ClearFlag_HT6(LOGIC_DMA);
+         if(!lc->full) logic_encode(lc, lc->dma);
+     }
+     if(LL_DMA_IsActiveFlag_TC6(LOGIC_DMA)){
+         LL_DMA_ClearFlag_TC6(LOGIC_DMA);
+         if(!lc->full) logic_encode(lc, lc->dma + LOGIC_BLOCK);
+     }
+ }
+ 
+ void logic_capture_start(LogicCapture* lc, uint32_t rate_hz){
+     lc->n_runs = 0;
+     lc->full = false;
+     lc->samples = 0;
+     lc->errors = 0;
+     lc->cur_run = 0;
+     lc->rate_hz = rate_hz;
+ 
+     furi_hal_gpio_init(&gpio_ext_pa6, GpioModeInput, GpioPullNo, GpioSpeedLow); // Listen only
+     furi_hal_gpio_init(&gpio_ext_pa4, GpioModeInput, GpioPullNo, GpioSpeedLow);
+     lc->cur = (uint16_t)(GPIOA->IDR & LOGIC_MASK); // First run starts at the current level
+ 
+     furi_hal_bus_enable(FuriHalBusTIM2);
+     LL_TIM_SetPrescaler(TIM2, 0);
+     LL_TIM_SetAutoReload(TIM2, LOGIC_TIM_HZ / rate_hz - 1);
+     LL_TIM_SetCounterMode(TIM2, LL_TIM_COUNTERMODE_UP);
+     LL_TIM_GenerateEvent_UPDATE(TIM2);          // Load ARR/PSC (before the DMA request is on)
+     LL_TIM_ClearFlag_UPDATE(TIM2);
+ 
+     LL_DMA_DisableChannel(LOGIC_DMA, LOGIC_DMA_CH);
+     LL_DMA_ConfigTransfer(LOGIC_DMA, LOGIC_DMA_CH,
+         LL_DMA_DIRECTION_PERIPH_TO_MEMORY | LL_DMA_MODE_CIRCULAR |
+         LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT |
+         LL_DMA_PDATAALIGN_HALFWORD | LL_DMA_MDATAALIGN_HALFWORD |
+         LL_DMA_PRIORITY_VERYHIGH);              // Snapshot timing is the whole point
+     LL_DMA_SetPeriphAddress(LOGIC_DMA, LOGIC_DMA_CH, (uint32_t)&GPIOA->IDR);
+     LL_DMA_SetMemoryAddress(LOGIC_DMA, LOGIC_DMA_CH, (uint32_t)lc->dma);
+     LL_DMA_SetDataLength(LOGIC_DMA, LOGIC_DMA_CH, 2 * LOGIC_BLOCK);
+     LL_DMA_SetPeriphRequest(LOGIC_DMA, LOGIC_DMA_CH, LL_DMAMUX_REQ_TIM2_UP);
+     LL_DMA_ClearFlag_GI6(LOGIC_DMA);
+     furi_hal_interrupt_set_isr(FuriHalInterruptIdDma2Ch6, logic_isr, lc);
+     LL_DMA_EnableIT_HT(LOGIC_DMA, LOGIC_DMA_CH);
+     LL_DMA_EnableIT_TC(LOGIC_DMA, LOGIC_DMA_CH);
+     LL_DMA_EnableIT_TE(LOGIC_DMA, LOGIC_DMA_CH);
+     LL_DMA_EnableChannel(LOGIC_DMA, LOGIC_DMA_CH);
+ 
+     lc->running = true;
+     LL_TIM_EnableDMAReq_UPDATE(TIM2);
+     LL_TIM_EnableCounter(TIM2);                 // From here on: hardware paced
+ }
+ 
+ void logic_capture_stop(LogicCapture* lc){
+     if(!lc->running) return;
+     logic_halt();
+     LL_DMA_DisableIT_HT(LOGIC_DMA, LOGIC_DMA_CH);
+     LL_DMA_DisableIT_TC(LOGIC_DMA, LOGIC_DMA_CH);
+     LL_DMA_DisableIT_TE(LOGIC_DMA, LOGIC_DMA_CH);
+     LL_DMA_ClearFlag_GI6(LOGIC_DMA);
+     furi_hal_interrupt_set_isr(FuriHalInterruptIdDma2Ch6, NULL, NULL);
+     furi_hal_bus_disable(FuriHalBusTIM2);
+     furi_hal_gpio_init(&gpio_ext_pa6, GpioModeAnalog, GpioPullNo, GpioSpeedLow); // Back to Hi-Z
+     furi_hal_gpio_init(&gpio_ext_pa4, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+     lc->running = false;
+     if(lc->cur_run && !lc->full) logic_emit(lc); // Keep the final level; the partial half is dropped
+     lc->cur_run = 0;
+ }
+ 
+ /* -- VCD export -- */
+ typedef struct {
+     File* f;
+     char buf[256];                              // Write coalescing: SD likes big writes
+     size_t len;
+     bool ok;
+ } VcdOut;
+ 
+ static void vcd_flush(VcdOut* o){
+     if(o->len && storage_file_write(o->f, o->buf, o->len) != o->len) o->ok = false;
+     o->len = 0;
+ }
+ 
+ static void vcd_put(VcdOut* o, const char* text, int n){ // Append one formatted line (snprintf result)
+     if(n <= 0) return;
+     if(o->len + (size_t)n > sizeof(o->buf)) vcd_flush(o);
+     memcpy(o->buf + o->len, text, (size_t)n);
+     o->len += (size_t)n;
+ }
+ 
+ bool logic_capture_save_vcd(const LogicCapture* lc, Storage* storage, const char* path){
+     File* f = storage_file_alloc(storage);
+     if(!storage_file_open(f, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)){
+         storage_file_free(f);
+         return false;
+     }
+     static VcdOut o;                            // 270 B: off the small app stack
+     o.f = f;
+     o.len = 0;
+     o.ok = true;
+ 
+     char line[64];
+     int n = snprintf(line, sizeof(line), "$timescale 1ns $end\n$scope module flipper $end\n");
+     vcd_put(&o, line, n);
+     for(uint8_t ch = 0; ch < LOGIC_CHANNELS; ch++){
+         n = snprintf(line, sizeof(line), "$var wire 1 %c %s $end\n", '!' + ch, kLogicPins[ch].name);
+         vcd_put(&o, line, n);
+     }
+     n = snprintf(line, sizeof(line), "$upscope $end\n$enddefinitions $end\n");
+     vcd_put(&o, line, n);
+ 
+     const uint64_t period_ns = 1000000000ULL / lc->rate_hz;
+     uint64_t t = 0;                             // Sample index of the current run
+     uint8_t prev = 0xFF;                        // Forces all channels out at #0
+     for(uint16_t i = 0; i < lc->n_runs; i++){
+         uint8_t bits = (uint8_t)(lc->runs[i] & 0xFFU);
+         if(bits != prev){                       // Runs split at LOGIC_RUN_MAX repeat the level
+             n = snprintf(line, sizeof(line), "#%llu\n", (unsigned long long)(t * period_ns));
+             vcd_put(&o, line, n);
+             for(uint8_t ch = 0; ch < LOGIC_CHANNELS; ch++){
+                 if(prev != 0xFF && ((bits ^ prev) & (1U << ch)) == 0) continue; // Unchanged
+                 n = snprintf(line, sizeof(line), "%c%c\n", (bits & (1U << ch)) ? '1' : '0', '!' + ch);
+                 vcd_put(&o, line, n);
+             }
+             prev = bits;
+         }
+         t += lc->runs[i] >> 8;
+     }
+     n = snprintf(line, sizeof(line), "#%llu\n", (unsigned long long)(t * period_ns)); // End time
+     vcd_put(&o, line, n);
+     vcd_flush(&o);
+ 
+     storage_file_close(f);
+     storage_file_free(f);
+     return o.ok;
+ }
@@ -0,0 +1,38 @@
+/*******************************************************************************************
+ * Expert Tool ICS — logic-analyzer capture
+ * -----------------------------------------------------------------------------------------
+ * TIM2 update events pace DMA2 channel 6, which snapshots GPIOA->IDR into a circular
+ * double buffer at a fixed rate. Header pins 2 (A7, our own PWM output), 3 (A6) and
+ * 4 (A4) are on that port. On every half-transfer / transfer-complete interrupt the
+ * filled half is run-length encoded into a run buffer (one 32-bit word per level
+ * change). Capture stops when the run buffer is full or on request, and can be saved
+ * as a VCD file that desktop analyzers (PulseView, GTKWave) open directly.
+ * Pins 3 and 4 are switched to floating inputs only while capturing; PA7 is only read.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include <storage/storage.h>                    // VCD export
+ #include <stdbool.h>                            // bool
+ #include <stdint.h>                             // Fixed-width integers
+ 
+ #define LOGIC_CHANNELS 3                        // Pins 2, 3, 4
+ #define LOGIC_BLOCK    512                      // IDR snapshots per DMA half
+ #define LOGIC_RUNS     4096                     // Run buffer entries (16 KB)
+ #define LOGIC_RUN_MAX  0x00FFFFFFU              // Longest run in one entry (24 bits)
+ 
+ typedef struct {
+     uint16_t dma[2 * LOGIC_BLOCK];              // Raw IDR snapshots (DMA target)
+     uint32_t runs[LOGIC_RUNS];                  // (run length << 8) | level bits
+     volatile uint16_t n_runs;                   // Entries used
+     volatile bool full;                         // Run buffer exhausted: capture stopped
+     volatile uint32_t samples;                  // Snapshots encoded so far
+     volatile uint32_t errors;                   // DMA transfer errors
+     uint16_t cur;                               // Masked IDR of the open run
+     uint32_t cur_run;                           // Length of the open run
+     uint32_t rate_hz;                           // Snapshot rate
+     bool running;                               // Timer + DMA active
+ } LogicCapture;
+ 
+ void logic_capture_start(LogicCapture* lc, uint32_t rate_hz); // Clear and start sampling
+ void logic_capture_stop(LogicCapture* lc);      // Stop, close the open run (idempotent)
+ bool logic_capture_save_vcd(const LogicCapture* lc, Storage* storage, const char* path);
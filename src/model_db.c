@@ -0,0 +1,95 @@
+/*******************************************************************************************
+ * Expert Tool ICS — compressor model database (see model_db.h)
+ *******************************************************************************************/
+ #include "model_db.h"
+ #include "inverter_family.h"                    // Family built-in profiles
+ #include <stdio.h>                              // snprintf
+ #include <string.h>                             // strncmp, strlen
+ 
+ /* Sorted by strcmp: model_db_prefix() and model_db_find() rely on it */
+ static const char kModelKeys[][MODEL_CODE_LEN] = {
+     "BMK089NAMV", "BMK110NAMV", "FMA092NAMA", "FMA102NAMA",                 // LG
+     "FMFT13HBX",  "FMFT3G",     "FMFT4G",     "FMXA9C",                     // Embraco FMF / FMX
+     "MK172CL2U",  "MK190CL2U",  "MKV190CL2B",                               // Samsung
+     "NLV10CNK",   "NLV15CNK",   "SLV15CNK",   "SLV21CNK",                   // Secop
+     "VEGT5H",     "VEGT7H",     "VEGY7H",     "VEMC9C",   "VEMT3H", "VEMX7C", // Embraco VEG / VEM
+     "VNEK213U",   "VNEK214U",   "VNEU213U",   "VNEU220U", "VNEX211U", "VNEY213U", // Embraco VNE
+     "VTC1018Y",   "VTC1023Y",                                               // Tecumseh
+ };
+ #define MODEL_COUNT (sizeof(kModelKeys) / sizeof(kModelKeys[0]))
+ 
+ #define LG    {InvLg,       0,    0,    0}      // Drive board: built-in LG ladder
+ #define FMF   {InvEmbraco, 30, 1800, 4500}
+ #define SAM   {InvSamsung,  0,    0,    0}      // Drive board: built-in Samsung ladder
+ #define NLV   {InvSecop,   30, 2000, 4400}
+ #define SLV   {InvSecop,   30, 2000, 4500}
+ #define VEG   {InvEmbraco, 30, 1800, 4500}
+ #define VNE   {InvEmbraco, 30, 2000, 4500}
+ #define VTC   {InvTecumseh, 30, 1800, 4000}
+ 
+ static const CompressorModel kModelInfo[MODEL_COUNT] = { // Same order as kModelKeys
+     LG, LG, LG, LG,
+     FMF, FMF, FMF, FMF,
+     SAM, SAM, SAM,
+     NLV, NLV, SLV, SLV,
+     VEG, VEG, VEG, VEG, VEG, VEG,
+     VNE, VNE, VNE, VNE, VNE, VNE,
+     VTC, VTC,
+ };
+ 
+ uint16_t model_db_count(void){ return MODEL_COUNT; }
+ 
+ const char* model_db_code(uint16_t i){ return kModelKeys[i]; } // Codes are shorter than the stride
+ 
+ const CompressorModel* model_db_get(uint16_t i){ return &kModelInfo[i]; }
+ 
+ /* First key whose first n characters compare >= prefix (upper: > prefix) */
+ static uint16_t bound(const char* prefix, size_t n, bool upper){
+     uint16_t lo = 0, hi = MODEL_COUNT;
+     while(lo < hi){
+         uint16_t mid = (uint16_t)(lo + (hi - lo) / 2);
+         int c = strncmp(kModelKeys[mid], prefix, n);
+         if(c < 0 || (upper && c == 0)) lo = (uint16_t)(mid + 1);
+         else hi = mid;
+     }
+     return lo;
+ }
+ 
+ uint16_t model_db_prefix(const char* prefix, uint16_t* count){
+     size_t n = strlen(prefix);
+     uint16_t first = bound(prefix, n, false);
+     *count = (uint16_t)(bound(prefix, n, true) - first); // Matches are contiguous
+     return first;
+ }
+ 
+ int32_t model_db_find(const char* code){
+     uint16_t i = bound(code, MODEL_CODE_LEN, false); // Full compare incl. padding
+     return (i < MODEL_COUNT && strncmp(kModelKeys[i], code, MODEL_CODE_LEN) == 0) ? i : -1;
+ }
+ 
+ bool model_db_profile(uint16_t i, Profile* out){
+     const CompressorModel* m = &kModelInfo[i];
+     *out = inverter_family_get(m->family)->profile;
+     if(m->rpm_per_hz == 0) return false;
+ 
+     const uint16_t lo_hz = (uint16_t)((m->rpm_min + m->rpm_per_hz / 2) / m->rpm_per_hz);
+     const uint16_t hi_hz = (uint16_t)((m->rpm_max + m->rpm_per_hz / 2) / m->rpm_per_hz);
+     const uint16_t hz[3] = {lo_hz, (uint16_t)((lo_hz + hi_hz) / 2), hi_hz};
+     static const char* const kRow[3] = {"Low", "Mid", "Max"};
+     snprintf(out->name, sizeof(out->name), "%s", kModelKeys[i]);
+     for(uint8_t r = 0; r < 3; r++){             // LED / auto-off of the family's rows 1..3
+         ProfileMode* md = &out->modes[1 + r];
+         uint32_t rpm = (r == 0) ? m->rpm_min : (r == 2) ? m->rpm_max : (uint32_t)hz[r] * m->rpm_per_hz;
+         snprintf(md->label, sizeof(md->label), "%s %lu", kRow[r], (unsigned long)rpm);
+         md->freq_hz = hz[r];
+     }
+     out->mode_count = 4;
+     return true;
+ }
+ 
+ bool model_db_sorted(void){
+     for(uint16_t i = 1; i < MODEL_COUNT; i++){
+         if(strncmp(kModelKeys[i - 1], kModelKeys[i], MODEL_CODE_LEN) >= 0) return false;
+     }
+     return true;
+ }
@@ -0,0 +1,36 @@
+/*******************************************************************************************
+ * Expert Tool ICS — compressor model database (flash)
+ * -----------------------------------------------------------------------------------------
+ * Maps the model code on a compressor label (e.g. "VNEU213U") to its inverter family,
+ * its speed range and the RPM per Hz of its speed signal. Keys are fixed-width,
+ * NUL-padded and stored back to back in strcmp order, apart from the attributes, so a
+ * lookup is a binary search over one dense array: any prefix finds its first match and
+ * its match count in about 2 * log2(n) key compares.
+ *
+ * Ranges are nominal catalogue values; the ladder built from them is a starting point
+ * and the label/datasheet of the unit under test has the last word.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include "profile_pack.h"                       // Profile
+ #include <stdbool.h>                            // bool
+ #include <stdint.h>                             // Fixed-width integers
+ 
+ #define MODEL_CODE_LEN 12                       // Longest code + NUL padding
+ 
+ typedef struct {
+     uint8_t  family;                            // InverterId
+     uint8_t  rpm_per_hz;                        // Speed signal scale (0 = not linear: family ladder)
+     uint16_t rpm_min;                           // Lowest rated speed
+     uint16_t rpm_max;                           // Highest rated speed
+ } CompressorModel;
+ 
+ uint16_t model_db_count(void);
+ const char* model_db_code(uint16_t i);          // NUL-terminated model code
+ const CompressorModel* model_db_get(uint16_t i);
+ uint16_t model_db_prefix(const char* prefix, uint16_t* count); // First match; *count = matches
+ int32_t model_db_find(const char* code);        // Exact code, -1 if unknown
+ /* Low / Mid / Max rows over the rated range, on top of the family's built-in profile
+ * (duty, 5V, LED, auto-off). false: no linear speed map, use the family profile. */
+ bool model_db_profile(uint16_t i, Profile* out);
+ bool model_db_sorted(void);                     // Table order check (furi_assert at startup)
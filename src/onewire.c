@@ -0,0 +1,131 @@
+/*******************************************************************************************
+ * Expert Tool ICS — 1-Wire bus + DS18B20 temperature probe (see onewire.h)
+ *******************************************************************************************/
+ #include "onewire.h"
+ 
+ /* ---------- Bit layer (standard-speed slot timing, µs) ---------- */
+ #define OW_RESET_LOW    480                     // Reset pulse
+ #define OW_PRESENCE_AT  70                      // Sample presence after release
+ #define OW_RESET_TAIL   410                     // Rest of the presence window
+ #define OW_W1_LOW       6                       // Write 1: short low
+ #define OW_W1_TAIL      64
+ #define OW_W0_LOW       60                      // Write 0: low for the whole slot
+ #define OW_W0_TAIL      10
+ #define OW_R_LOW        6                       // Read: start slot
+ #define OW_R_SAMPLE     9                       // Sample within 15 µs of the falling edge
+ #define OW_R_TAIL       55
+ 
+ bool onewire_reset(const OneWireHal* h){
+     h->set(h->ctx, false);                      // Long low: no need to lock out interrupts
+     h->delay_us(h->ctx, OW_RESET_LOW);
+     h->lock(h->ctx, true);
+     h->set(h->ctx, true);
+     h->delay_us(h->ctx, OW_PRESENCE_AT);
+     bool present = !h->get(h->ctx);             // Device pulls low to say "here"
+     h->lock(h->ctx, false);
+     h->delay_us(h->ctx, OW_RESET_TAIL);
+     return present;
+ }
+ 
+ static void onewire_write_bit(const OneWireHal* h, bool bit){
+     h->lock(h->ctx, true);                      // The low time is what encodes the bit
+     h->set(h->ctx, false);
+     h->delay_us(h->ctx, bit ? OW_W1_LOW : OW_W0_LOW);
+     h->set(h->ctx, true);
+     h->lock(h->ctx, false);
+     h->delay_us(h->ctx, bit ? OW_W1_TAIL : OW_W0_TAIL);
+ }
+ 
+ static bool onewire_read_bit(const OneWireHal* h){
+     h->lock(h->ctx, true);
+     h->set(h->ctx, false);
+     h->delay_us(h->ctx, OW_R_LOW);
+     h->set(h->ctx, true);
+     h->delay_us(h->ctx, OW_R_SAMPLE);
+     bool bit = h->get(h->ctx);                  // Device holds low for a 0
+     h->lock(h->ctx, false);
+     h->delay_us(h->ctx, OW_R_TAIL);
+     return bit;
+ }
+ 
+ void onewire_write_byte(const OneWireHal* h, uint8_t v){
+     for(uint8_t i = 0; i < 8; i++) onewire_write_bit(h, (v >> i) & 1U);
+ }
+ 
+ uint8_t onewire_read_byte(const OneWireHal* h){
+     uint8_t v = 0;
+     for(uint8_t i = 0; i < 8; i++) if(onewire_read_bit(h)) v |= (uint8_t)(1U << i);
+     return v;
+ }
+ 
+ uint8_t onewire_crc8(const uint8_t* data, size_t len){
+     uint8_t crc = 0;
+     for(size_t i = 0; i < len; i++){
+         uint8_t b = data[i];
+         for(uint8_t j = 0; j < 8; j++){
+             uint8_t mix = (crc ^ b) & 1U;
+             crc >>= 1;
+             if(mix) crc ^= 0x8C;
+             b >>= 1;
+         }
+     }
+     return crc;
+ }
+ 
+ /* ---------- DS18B20 ---------- */
+ #define DS_SKIP_ROM   0xCC                      // Single probe on the bus: address everyone
+ #define DS_CONVERT_T  0x44
+ #define DS_READ_PAD   0xBE
+ #define DS_POWERON_RAW 0x0550                   // 85.0 °C: scratchpad default before any conversion
+ 
+ void ds18b20_init(Ds18b20* d, const OneWireHal* hal){
+     d->hal = hal;
+     d->converting = false;
+     d->present = false;
+     d->first = true;
+     d->t_start_ms = 0;
+     d->temp_dc = DS18B20_NO_READING;
+     d->t_sample_ms = 0;
+     d->crc_errors = 0;
+ }
+ 
+ static bool ds18b20_collect(Ds18b20* d){        // Read the finished conversion
+     if(!onewire_reset(d->hal)) return false;
+     onewire_write_byte(d->hal, DS_SKIP_ROM);
+     onewire_write_byte(d->hal, DS_READ_PAD);
+     uint8_t pad[9];
+     for(uint8_t i = 0; i < sizeof(pad); i++) pad[i] = onewire_read_byte(d->hal);
+     if(onewire_crc8(pad, 8) != pad[8]){         // Noise, or the probe went away mid-read
+         d->crc_errors++;
+         return false;
+     }
+     int16_t raw = (int16_t)((uint16_t)pad[1] << 8 | pad[0]); // 1/16 °C
+     bool poweron = d->first && raw == DS_POWERON_RAW;
+     d->first = false;
+     if(poweron) return false;                   // Conversion never ran (brown-out / hot plug)
+     d->temp_dc = (int16_t)((raw * 10) / 16);
+     d->t_sample_ms = d->t_start_ms;             // Temperature was latched when conversion began
+     return true;
+ }
+ 
+ bool ds18b20_poll(Ds18b20* d, uint32_t now_ms){
+     bool got = false;
+     if(d->converting){
+         if(now_ms - d->t_start_ms < DS18B20_CONVERT_MS) return false; // Not done: come back later
+         d->converting = false;
+         got = ds18b20_collect(d);
+     } else if(!d->present && now_ms - d->t_start_ms < DS18B20_RETRY_MS && d->t_start_ms){
+         return false;                           // Nothing answered recently: probe slowly
+     }
+ 
+     d->t_start_ms = now_ms ? now_ms : 1;        // 0 means "never probed"
+     d->present = onewire_reset(d->hal);         // Start the next conversion straight away
+     if(d->present){
+         onewire_write_byte(d->hal, DS_SKIP_ROM);
+         onewire_write_byte(d->hal, DS_CONVERT_T);
+         d->converting = true;
+     } else {
+         d->first = true;                        // A newly attached probe starts at 85 °C
+     }
+     return got;
+ }
@@ -0,0 +1,49 @@
+/*******************************************************************************************
+ * Expert Tool ICS — 1-Wire bus + DS18B20 temperature probe
+ * -----------------------------------------------------------------------------------------
+ * Bit-level 1-Wire (standard speed) on top of a small HAL of function pointers, so the
+ * timing layer runs unchanged against a simulated bus on a PC. Interrupts are only
+ * held off for the timing-critical part of each slot (<= 70 µs).
+ *
+ * The DS18B20 layer never waits for a conversion: ds18b20_poll() starts one, returns,
+ * and collects the result on a later call once the conversion time has passed.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include <stdbool.h>                            // bool
+ #include <stddef.h>                             // size_t
+ #include <stdint.h>                             // Fixed-width integers
+ 
+ typedef struct {
+     void (*set)(void* ctx, bool release);       // false: pull the bus low; true: release it
+     bool (*get)(void* ctx);                     // Sample the bus level
+     void (*delay_us)(void* ctx, uint32_t us);   // Busy-wait (slot timing only)
+     void (*lock)(void* ctx, bool on);           // Interrupts off (true) / back on (false)
+     void* ctx;
+ } OneWireHal;
+ 
+ bool onewire_reset(const OneWireHal* h);        // Reset pulse; true if a device answered
+ void onewire_write_byte(const OneWireHal* h, uint8_t v); // LSB first
+ uint8_t onewire_read_byte(const OneWireHal* h); // LSB first
+ uint8_t onewire_crc8(const uint8_t* data, size_t len); // Dallas/Maxim CRC (poly 0x31 reflected)
+ 
+ #define DS18B20_CONVERT_MS 750                  // 12-bit conversion time (datasheet max)
+ #define DS18B20_RETRY_MS   3000                 // Re-probe period when nothing answers
+ #define DS18B20_NO_READING INT16_MIN            // temp_dc before the first good reading
+ 
+ typedef struct {
+     const OneWireHal* hal;                      // Bus access
+     bool converting;                            // A conversion is in progress
+     bool present;                               // Probe answered the last reset
+     bool first;                                 // Next result may be the 85 °C power-on value
+     uint32_t t_start_ms;                        // Conversion start (= sample time) / last probe
+     int16_t temp_dc;                            // Last good reading, 0.1 °C
+     uint32_t t_sample_ms;                       // When that reading was taken
+     uint16_t crc_errors;                        // Scratchpad reads that failed the CRC
+ } Ds18b20;
+ 
+ void ds18b20_init(Ds18b20* d, const OneWireHal* hal);
+ 
+ /* Call often (e.g. every main-loop tick); each call costs at most one short bus
+  * transaction (~7 ms). Returns true when a new reading landed in temp_dc. */
+ bool ds18b20_poll(Ds18b20* d, uint32_t now_ms);
@@ -0,0 +1,109 @@
+/*******************************************************************************************
+ * Expert Tool ICS — live frequency/time plot (see plot.h)
+ *******************************************************************************************/
+ #include "plot.h"
+ #include <string.h>                             // memset
+ 
+ /* ---------- Pixel helpers ---------- */
+ static inline void px_set(Plot* p, uint8_t x, uint8_t y){ // Set one chart pixel
+     p->bitmap[y * PLOT_STRIDE + (x >> 3)] |= (uint8_t)(1U << (x & 7));
+ }
+ 
+ static uint8_t freq_to_y(const Plot* p, uint16_t f){ // Map Hz -> row (0 = top)
+     if(p->freq_max == 0) return PLOT_H - 1;     // No scale yet: flat line at bottom
+     if(f > p->freq_max) f = p->freq_max;        // Clip above full-scale
+     return (uint8_t)(PLOT_H - 1 - ((uint32_t)f * (PLOT_H - 1)) / p->freq_max);
+ }
+ 
+ static bool meas_to_y(const Plot* p, int16_t v, uint8_t* y){ // Map measurement -> row
+     if(v == PLOT_NO_VALUE || p->meas_max <= p->meas_min) return false; // Nothing to draw
+     int32_t span = (int32_t)p->meas_max - p->meas_min; // Full-scale span
+     int32_t rel  = (int32_t)v - p->meas_min;    // Offset from bottom
+     if(rel < 0) rel = 0;                        // Clip below
+     if(rel > span) rel = span;                  // Clip above
+     *y = (uint8_t)(PLOT_H - 1 - (rel * (PLOT_H - 1)) / span);
+     return true;
+ }
+ 
+ /* Draw sample `cur` into column x, joined vertically to `prev` so steps are visible */
+ static void draw_column(Plot* p, uint8_t x, const PlotSample* prev, const PlotSample* cur){
+     uint8_t y1 = freq_to_y(p, cur->freq_hz);    // Current level
+     uint8_t y0 = prev ? freq_to_y(p, prev->freq_hz) : y1; // Previous level (or same)
+     if(y0 > y1){ uint8_t t = y0; y0 = y1; y1 = t; } // Order top..bottom
+     for(uint8_t y = y0; y <= y1; y++) px_set(p, x, y); // Vertical segment
+ 
+     uint8_t my;                                 // Measured trace: single dot per column
+     if(meas_to_y(p, cur->measured, &my)) px_set(p, x, my);
+ 
+     if(cur->temp_dc != PLOT_NO_VALUE){          // Temperature trace: 2-pixel mark, fixed scale
+         int32_t rel = cur->temp_dc - PLOT_TEMP_MIN_DC;
+         if(rel < 0) rel = 0;
+         if(rel > PLOT_TEMP_MAX_DC - PLOT_TEMP_MIN_DC) rel = PLOT_TEMP_MAX_DC - PLOT_TEMP_MIN_DC;
+         uint8_t ty = (uint8_t)(PLOT_H - 1 - (rel * (PLOT_H - 1)) / (PLOT_TEMP_MAX_DC - PLOT_TEMP_MIN_DC));
+         px_set(p, x, ty);
+         px_set(p, x, ty ? (uint8_t)(ty - 1) : 1);
+     }
+ }
+ 
+ /* Shift every bitmap row one pixel left (XBM: left pixel is bit 0) */
+ static void shift_left(Plot* p){
+     for(uint8_t y = 0; y < PLOT_H; y++){
+         uint8_t* row = &p->bitmap[y * PLOT_STRIDE];
+         for(uint8_t b = 0; b < PLOT_STRIDE; b++){
+             uint8_t carry = (b + 1 < PLOT_STRIDE) ? (uint8_t)(row[b + 1] << 7) : 0; // Next byte's left pixel
+             row[b] = (uint8_t)((row[b] >> 1) | carry);
+         }
+     }
+ }
+ 
+ static const PlotSample* sample_at(const Plot* p, uint16_t i){ // i = 0 is oldest
+     uint16_t start = (uint16_t)((p->head + PLOT_SAMPLES - p->count) % PLOT_SAMPLES);
+     return &p->ring[(start + i) % PLOT_SAMPLES];
+ }
+ 
+ /* Full re-render (only after a scale change) */
+ static void rerender(Plot* p){
+     memset(p->bitmap, 0, sizeof(p->bitmap));
+     uint8_t x0 = (uint8_t)(PLOT_W - p->count);  // Newest sample sits in the last column
+     for(uint16_t i = 0; i < p->count; i++){
+         draw_column(p, (uint8_t)(x0 + i), i ? sample_at(p, (uint16_t)(i - 1)) : NULL, sample_at(p, i));
+     }
+ }
+ 
+ /* ---------- Public API ---------- */
+ void plot_reset(Plot* p, uint16_t freq_max){
+     memset(p, 0, sizeof(*p));                   // Empty ring, blank bitmap
+     p->freq_max = freq_max;                     // Frequency full-scale
+ }
+ 
+ void plot_set_scale(Plot* p, uint16_t freq_max, int16_t meas_min, int16_t meas_max){
+     if(p->freq_max == freq_max && p->meas_min == meas_min && p->meas_max == meas_max) return;
+     p->freq_max = freq_max;
+     p->meas_min = meas_min;
+     p->meas_max = meas_max;
+     rerender(p);                                // Rare: inverter change / new sensor range
+ }
+ 
+ void plot_push(Plot* p, uint32_t t_ms, uint16_t freq_hz, int16_t measured, int16_t temp_dc){
+     const PlotSample* prev = plot_latest(p);    // For the vertical join (different slot)
+ 
+     PlotSample* slot = &p->ring[p->head];       // Store in ring
+     slot->t_ms = t_ms;
+     slot->freq_hz = freq_hz;
+     slot->measured = measured;
+     slot->temp_dc = temp_dc;
+     p->head = (uint16_t)((p->head + 1) % PLOT_SAMPLES);
+     if(p->count < PLOT_SAMPLES) p->count++;
+ 
+     shift_left(p);                              // Scroll chart one column
+     draw_column(p, PLOT_W - 1, prev, slot);     // Paint only the new column
+ }
+ 
+ const PlotSample* plot_latest(const Plot* p){
+     if(p->count == 0) return NULL;
+     return &p->ring[(p->head + PLOT_SAMPLES - 1) % PLOT_SAMPLES];
+ }
+ 
+ void plot_draw(const Plot* p, Canvas* c, int32_t y){
+     canvas_draw_xbm(c, 0, y, PLOT_W, PLOT_H, p->bitmap); // One blit, no per-point work
+ }
@@ -0,0 +1,54 @@
+/*******************************************************************************************
+ * Expert Tool ICS — live frequency/time plot
+ * -----------------------------------------------------------------------------------------
+ * Fixed-size ring buffer of (timestamp, commanded frequency, optional measured value,
+ * optional temperature) samples plus a 1-bit chart bitmap that is shifted one column per
+ * sample, so the draw callback only blits the bitmap instead of re-plotting every point.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include <gui/canvas.h>                         // Canvas used by plot_draw()
+ #include <stdbool.h>                            // bool
+ #include <stdint.h>                             // Fixed-width integers
+ 
+ #define PLOT_W        128                       // Chart width in pixels == samples kept
+ #define PLOT_H        48                        // Chart height in pixels
+ #define PLOT_STRIDE   (PLOT_W / 8)              // Bytes per bitmap row (XBM, LSB = left pixel)
+ #define PLOT_SAMPLES  PLOT_W                    // One sample per pixel column
+ #define PLOT_NO_VALUE INT16_MIN                 // "measured" / "temp_dc" field is empty
+ #define PLOT_TEMP_MIN_DC 0                      // Temperature trace bottom (0.1 °C)
+ #define PLOT_TEMP_MAX_DC 1200                   // Temperature trace top: 120 °C
+ 
+ typedef struct {
+     uint32_t t_ms;                              // Sample time (furi tick, ms)
+     uint16_t freq_hz;                           // Commanded PWM frequency (0 => no output)
+     int16_t  measured;                          // Optional measurement (PLOT_NO_VALUE if none)
+     int16_t  temp_dc;                           // Probe temperature, 0.1 °C (PLOT_NO_VALUE if none)
+ } PlotSample;
+ 
+ typedef struct {
+     PlotSample ring[PLOT_SAMPLES];              // Sample history (oldest overwritten)
+     uint16_t head;                              // Next write slot
+     uint16_t count;                             // Valid samples (<= PLOT_SAMPLES)
+ 
+     uint16_t freq_max;                          // Frequency mapped to the top row
+     int16_t  meas_min;                          // Measured value mapped to the bottom row
+     int16_t  meas_max;                          // Measured value mapped to the top row
+ 
+     uint8_t bitmap[PLOT_H * PLOT_STRIDE];       // Rendered chart, shifted left per sample
+ } Plot;
+ 
+ /* Clear history and bitmap; set frequency full-scale */
+ void plot_reset(Plot* p, uint16_t freq_max);
+ 
+ /* Change scales; re-renders the bitmap from the ring only if a scale actually changed */
+ void plot_set_scale(Plot* p, uint16_t freq_max, int16_t meas_min, int16_t meas_max);
+ 
+ /* Append one sample: O(bitmap) shift + one new column, no full re-plot */
+ void plot_push(Plot* p, uint32_t t_ms, uint16_t freq_hz, int16_t measured, int16_t temp_dc);
+ 
+ /* Most recent sample, or NULL if empty */
+ const PlotSample* plot_latest(const Plot* p);
+ 
+ /* Blit chart with its top-left corner at (0, y) */
+ void plot_draw(const Plot* p, Canvas* c, int32_t y);
@@ -0,0 +1,289 @@
+/*******************************************************************************************
+ * Expert Tool ICS — inverter profile packs (see profile_pack.h)
+ *******************************************************************************************/
+ #include "profile_pack.h"
+ #include "inverter_family.h"                    // Family keys
+ #include <stdio.h>                              // snprintf
+ #include <stdlib.h>                             // malloc, strtoul, qsort
+ #include <string.h>                             // strcmp, strchr, memset
+ 
+ #define PROFILE_CACHE_MAGIC   0x50534349U       // "ICSP" little-endian
+ #define PROFILE_CACHE_VERSION 2                 // 2: Secop / Tecumseh / LG family keys
+ #define PROFILE_PATH_LEN      128               // dir + "/" + file name
+ 
+ typedef struct {
+     uint32_t magic;                             // PROFILE_CACHE_MAGIC
+     uint16_t version;                           // PROFILE_CACHE_VERSION
+     uint16_t record_size;                       // sizeof(Profile): layout guard
+     uint32_t source_sig;                        // Fingerprint of the source directory
+     uint8_t  count;                             // Records that follow the header
+     uint8_t  rejected;                          // Sources that failed (hint after load)
+     uint16_t reserved;
+     uint32_t crc;                               // CRC-32 of the records
+ } ProfileCacheHeader;
+ 
+ /* ---------- Checksums ---------- */
+ static uint32_t crc32_update(uint32_t crc, const void* data, size_t len){ // IEEE 802.3, bitwise
+     const uint8_t* p = data;
+     crc = ~crc;
+     while(len--){
+         crc ^= *p++;
+         for(uint8_t b = 0; b < 8; b++) crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+     }
+     return ~crc;
+ }
+ 
+ static uint32_t fnv1a(uint32_t h, const void* data, size_t len){ // Directory fingerprint
+     const uint8_t* p = data;
+     while(len--){ h ^= *p++; h *= 16777619U; }
+     return h;
+ }
+ 
+ /* ---------- Directory scan ---------- */
+ static bool is_source(const FileInfo* fi, const char* name){ // Regular "*.txt" file
+     if(fi->flags & FSF_DIRECTORY) return false;
+     size_t n = strlen(name);
+     return n > 4 && strcmp(name + n - 4, ".txt") == 0;
+ }
+ 
+ /* Fingerprint of every source: order-independent sum of per-file hashes, so the cache
+  * stays valid however the file system happens to order the directory */
+ static uint32_t scan_sources(Storage* storage, const char* dir, uint8_t* sources){
+     uint32_t sig = 0;
+     *sources = 0;
+     File* d = storage_file_alloc(storage);
+     if(storage_dir_open(d, dir)){
+         FileInfo fi;
+         char name[64];
+         char path[PROFILE_PATH_LEN];
+         while(*sources < PROFILE_PACK_MAX && storage_dir_read(d, &fi, name, sizeof(name))){
+             if(!is_source(&fi, name)) continue;
+             uint32_t ts = 0;                    // Catches same-size edits
+             snprintf(path, sizeof(path), "%s/%s", dir, name);
+             storage_common_timestamp(storage, path, &ts);
+             uint32_t size = (uint32_t)fi.size;
+             uint32_t h = fnv1a(2166136261U, name, strlen(name));
+             h = fnv1a(h, &size, sizeof(size));
+             h = fnv1a(h, &ts, sizeof(ts));
+             sig += h;
+             (*sources)++;
+         }
+     }
+     storage_dir_close(d);
+     storage_file_free(d);
+     return fnv1a(sig, sources, 1);              // Count too: a removed file changes the sum
+ }
+ 
+ /* ---------- Text compiler ---------- */
+ static char* trim(char* s){                     // Strip blanks in place
+     while(*s == ' ' || *s == '\t') s++;
+     char* e = s + strlen(s);
+     while(e > s && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r')) *--e = '\0';
+     return s;
+ }
+ 
+ static bool parse_uint(const char* s, uint32_t min, uint32_t max, uint32_t* out){
+     char* end;
+     unsigned long v = strtoul(s, &end, 10);
+     if(end == s || *end != '\0' || v < min || v > max) return false;
+     *out = (uint32_t)v;
+     return true;
+ }
+ 
+ static bool copy_text(char* dst, size_t cap, const char* src){ // Non-empty, fits incl. NUL
+     size_t n = strlen(src);
+     if(n == 0 || n >= cap) return false;
+     memcpy(dst, src, n + 1);
+     return true;
+ }
+ 
+ static bool parse_mode(char* v, ProfileMode* m){ // "label, Hz, LED Hz, auto-off s"
+     char* f[4];
+     for(uint8_t i = 0; i < 4; i++){
+         f[i] = v;
+         char* comma = strchr(v, ',');
+         if(i < 3){
+             if(!comma) return false;
+             *comma = '\0';
+             v = comma + 1;
+         } else if(comma) return false;          // Too many fields
+         f[i] = trim(f[i]);
+     }
+     uint32_t hz, led, secs;
+     if(!copy_text(m->label, sizeof(m->label), f[0])) return false;
+     if(!parse_uint(f[1], 1, 20000, &hz)) return false; // furi_hal_pwm_start() range we trust
+     if(!parse_uint(f[2], 0, 10, &led)) return false;   // Blink period >= 100 ms
+     if(!parse_uint(f[3], 0, 3600, &secs)) return false;
+     m->freq_hz = (uint16_t)hz;
+     m->led_hz = (uint8_t)led;
+     m->auto_off_s = (uint16_t)secs;
+     return true;
+ }
+ 
+ /* Compile one NUL-terminated source into p. Unknown keys reject the file so typos
+  * surface as a hint instead of a silently different profile. */
+ static bool profile_compile(char* text, const char* fallback_name, Profile* p){
+     memset(p, 0, sizeof(*p));
+     p->duty_pct = 50;
+     p->mode_count = 1;
+     copy_text(p->modes[0].label, sizeof(p->modes[0].label), "Stand by");
+     snprintf(p->name, sizeof(p->name), "%s", fallback_name);
+ 
+     for(char* line = text; line; ){
+         char* next = strchr(line, '\n');
+         if(next) *next++ = '\0';
+         char* hash = strchr(line, '#');
+         if(hash) *hash = '\0';
+         char* l = trim(line);
+         line = next;
+         if(*l == '\0') continue;                // Blank or comment-only line
+ 
+         char* eq = strchr(l, '=');
+         if(!eq) return false;
+         *eq = '\0';
+         const char* key = trim(l);
+         char* val = trim(eq + 1);
+         uint32_t u;
+ 
+         if(strcmp(key, "name") == 0){
+             if(!copy_text(p->name, sizeof(p->name), val)) return false;
+         } else if(strcmp(key, "family") == 0){
+             int8_t id = inverter_family_find(val);
+             if(id < 0) return false;
+             p->family = (uint8_t)id;
+         } else if(strcmp(key, "5v") == 0){
+             if(strcmp(val, "yes") == 0) p->needs_5v = 1;
+             else if(strcmp(val, "no") == 0) p->needs_5v = 0;
+             else return false;
+         } else if(strcmp(key, "duty") == 0){
+             if(!parse_uint(val, 1, 99, &u)) return false;
+             p->duty_pct = (uint8_t)u;
+         } else if(strcmp(key, "mode") == 0){
+             if(p->mode_count >= PROFILE_MAX_MODES) return false;
+             if(!parse_mode(val, &p->modes[p->mode_count])) return false;
+             p->mode_count++;
+         } else {
+             return false;
+         }
+     }
+     return p->mode_count > 1;                   // At least one powered speed
+ }
+ 
+ static bool compile_file(Storage* storage, const char* path, const char* fallback_name, Profile* p, char* buf){
+     File* f = storage_file_alloc(storage);
+     bool ok = false;
+     if(storage_file_open(f, path, FSAM_READ, FSOM_OPEN_EXISTING)){
+         uint64_t size = storage_file_size(f);
+         if(size < PROFILE_SRC_MAX && storage_file_read(f, buf, (size_t)size) == size){
+             buf[size] = '\0';
+             ok = profile_compile(buf, fallback_name, p);
+         }
+     }
+     storage_file_close(f);
+     storage_file_free(f);
+     return ok;
+ }
+ 
+ static int profile_cmp(const void* a, const void* b){ // Stable menu order
+     return strcmp(((const Profile*)a)->name, ((const Profile*)b)->name);
+ }
+ 
+ /* Parse every source into pack (capacity: sources) and sort by name */
+ static void compile_dir(ProfilePack* pack, Storage* storage, const char* dir, uint8_t sources){
+     char* buf = malloc(PROFILE_SRC_MAX);        // Source text (too big for the app stack)
+     File* d = storage_file_alloc(storage);
+     if(buf && storage_dir_open(d, dir)){
+         FileInfo fi;
+         char name[64];
+         char path[PROFILE_PATH_LEN];
+         uint8_t seen = 0;
+         while(seen < sources && storage_dir_read(d, &fi, name, sizeof(name))){
+             if(!is_source(&fi, name)) continue;
+             seen++;
+             snprintf(path, sizeof(path), "%s/%s", dir, name);
+             name[strlen(name) - 4] = '\0';      // File name without ".txt" as default name
+             if(compile_file(storage, path, name, &pack->items[pack->count], buf)) pack->count++;
+             else pack->rejected++;
+         }
+     }
+     storage_dir_close(d);
+     storage_file_free(d);
+     free(buf);
+     if(pack->count > 1) qsort(pack->items, pack->count, sizeof(Profile), profile_cmp);
+ }
+ 
+ /* ---------- Cache ---------- */
+ static bool cache_read(ProfilePack* pack, Storage* storage, const char* path, uint32_t sig){
+     File* f = storage_file_alloc(storage);
+     bool ok = false;
+     ProfileCacheHeader h;
+     if(storage_file_open(f, path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+        storage_file_read(f, &h, sizeof(h)) == sizeof(h) &&
+        h.magic == PROFILE_CACHE_MAGIC && h.version == PROFILE_CACHE_VERSION &&
+        h.record_size == sizeof(Profile) && h.source_sig == sig &&
+        h.count > 0 && h.count <= PROFILE_PACK_MAX){
+         size_t bytes = (size_t)h.count * sizeof(Profile);
+         pack->items = malloc(bytes);
+         if(pack->items && storage_file_read(f, pack->items, bytes) == bytes &&
+            crc32_update(0, pack->items, bytes) == h.crc){
+             pack->count = h.count;
+             pack->rejected = h.rejected;
+             ok = true;
+         } else {
+             free(pack->items);                  // Truncated or corrupt: recompile
+             pack->items = NULL;
+         }
+     }
+     storage_file_close(f);
+     storage_file_free(f);
+     return ok;
+ }
+ 
+ static void cache_write(const ProfilePack* pack, Storage* storage, const char* path, uint32_t sig){
+     size_t bytes = (size_t)pack->count * sizeof(Profile);
+     ProfileCacheHeader h = {
+         .magic = PROFILE_CACHE_MAGIC,
+         .version = PROFILE_CACHE_VERSION,
+         .record_size = sizeof(Profile),
+         .source_sig = sig,
+         .count = pack->count,
+         .rejected = pack->rejected,
+         .crc = crc32_update(0, pack->items, bytes),
+     };
+     File* f = storage_file_alloc(storage);
+     bool ok = storage_file_open(f, path, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+               storage_file_write(f, &h, sizeof(h)) == sizeof(h) &&
+               storage_file_write(f, pack->items, bytes) == bytes;
+     storage_file_close(f);
+     storage_file_free(f);
+     if(!ok) storage_common_remove(storage, path); // Never leave a half-written cache
+ }
+ 
+ /* ---------- Public API ---------- */
+ void profile_pack_load(ProfilePack* pack, Storage* storage, const char* dir, const char* cache_path){
+     memset(pack, 0, sizeof(*pack));
+     uint8_t sources;
+     uint32_t sig = scan_sources(storage, dir, &sources);
+     if(sources == 0) return;                    // Nothing installed: built-ins only
+ 
+     if(cache_read(pack, storage, cache_path, sig)){
+         pack->from_cache = true;
+         return;
+     }
+ 
+     pack->items = malloc((size_t)sources * sizeof(Profile));
+     if(!pack->items) return;
+     compile_dir(pack, storage, dir, sources);
+     if(pack->count == 0){                       // Keep the rejected count for the hint
+         free(pack->items);
+         pack->items = NULL;
+         return;
+     }
+     cache_write(pack, storage, cache_path, sig);
+ }
+ 
+ void profile_pack_free(ProfilePack* pack){
+     free(pack->items);
+     pack->items = NULL;
+     pack->count = 0;
+ }
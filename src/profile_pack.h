@@ -0,0 +1,62 @@
+/*******************************************************************************************
+ * Expert Tool ICS — inverter profile packs (SD card)
+ * -----------------------------------------------------------------------------------------
+ * A profile is everything the starter needs to drive one compressor model: name, speeds,
+ * PWM duty, LED pattern, auto-off times and whether the OTG 5V rail must be up. Extra
+ * profiles are plain text files on the SD card, one per file, e.g. "secop_bd35f.txt":
+ *
+ *     # Lines starting with '#' are comments; keys and keywords are lower case
+ *     name   = Secop BD35F
+ *     family = secop                      # embraco | samsung | secop | tecumseh | lg
+ *     5v     = no                         # yes: OTG 5V must be up before any PWM
+ *     duty   = 50                         # PWM duty, percent
+ *     mode   = Low speed, 55, 1, 120      # label, Hz, LED blink Hz, auto-off s (0 = none)
+ *     mode   = Max speed, 150, 4, 30
+ *
+ * "Stand by" is always row 0 and is inserted by the compiler. The first load compiles all
+ * *.txt files into an array of fixed-size records and writes it to a cache file behind a
+ * header holding a fingerprint of the source directory (names, sizes, timestamps) and a
+ * CRC-32 of the records. Later launches only list the directory; when the fingerprint
+ * still matches, the pack comes back with one sequential read and no parsing. Editing,
+ * adding or removing a file rebuilds the cache on the next launch.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include <storage/storage.h>                    // SD access
+ #include <stdbool.h>                            // bool
+ #include <stdint.h>                             // Fixed-width integers
+ 
+ #define PROFILE_NAME_LEN   16                   // Profile name incl. NUL (title bar width)
+ #define PROFILE_LABEL_LEN  12                   // Mode row label incl. NUL
+ #define PROFILE_MAX_MODES  6                    // Rows incl. Stand by
+ #define PROFILE_PACK_MAX   64                   // Source files considered per directory
+ #define PROFILE_SRC_MAX    1024                 // Largest accepted source file (bytes)
+ 
+ typedef struct {
+     char     label[PROFILE_LABEL_LEN];          // Row label
+     uint16_t freq_hz;                           // PWM frequency (0 => Stand by = no PWM)
+     uint8_t  led_hz;                            // LED blink frequency (0 => LED off)
+     uint8_t  reserved;                          // Keeps the record layout explicit
+     uint16_t auto_off_s;                        // Auto-off seconds (if limit_runtime == true)
+ } ProfileMode;
+ 
+ typedef struct {
+     char     name[PROFILE_NAME_LEN];            // Shown in the title and the inverter list
+     uint8_t  family;                            // Signalling family (index into InverterId)
+     uint8_t  needs_5v;                          // 1: OTG 5V rail required before PWM
+     uint8_t  duty_pct;                          // PWM duty cycle, 1..99 %
+     uint8_t  mode_count;                        // Rows used in modes[] (Stand by included)
+     ProfileMode modes[PROFILE_MAX_MODES];       // Row 0 is always Stand by
+ } Profile;                                      // 128 bytes: also the cache record
+ 
+ typedef struct {
+     Profile* items;                             // Heap, sorted by name (NULL when empty)
+     uint8_t  count;                             // Valid profiles
+     uint8_t  rejected;                          // Source files that failed to compile
+     bool     from_cache;                        // true: loaded without parsing
+ } ProfilePack;
+ 
+ /* Load every profile from dir, through the cache at cache_path. Never fails: a missing
+  * directory, unreadable files or a broken cache just give fewer (or zero) profiles. */
+ void profile_pack_load(ProfilePack* pack, Storage* storage, const char* dir, const char* cache_path);
+ void profile_pack_free(ProfilePack* pack);      // Release items (idempotent)
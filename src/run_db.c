@@ -0,0 +1,307 @@
+/*******************************************************************************************
+ * Expert Tool ICS — run-hours database (see run_db.h)
+ *******************************************************************************************/
+ #include "run_db.h"
+ #include <stdio.h>                              // snprintf
+ #include <string.h>                             // memset
+ 
+ #define RUN_DB_JNL_MAGIC 0x4A534349U            // "ICSJ"
+ #define RUN_DB_IDX_MAGIC 0x58534349U            // "ICSX"
+ #define RUN_DB_VERSION   1
+ 
+ typedef struct {
+     uint32_t magic;                             // RUN_DB_JNL_MAGIC
+     uint32_t epoch;                             // Generation; must match the snapshot
+ } RunDbJournalHeader;
+ 
+ typedef struct {
+     uint32_t magic;                             // RUN_DB_IDX_MAGIC
+     uint16_t version;                           // RUN_DB_VERSION
+     uint16_t entry_size;                        // sizeof(RunDbTotals): layout guard
+     uint32_t epoch;                             // Journal generation this snapshot covers
+     uint32_t folded;                            // Records of that journal already included
+     uint32_t count;                             // Entries that follow, sorted by hash
+ } RunDbSnapHeader;
+ 
+ /* ---------- Hashing / totals ---------- */
+ uint32_t run_db_hash(const char* serial){
+     uint32_t h = 2166136261U;
+     for(; *serial; serial++){
+         char ch = *serial;
+         if(ch >= 'a' && ch <= 'z') ch = (char)(ch - 'a' + 'A'); // Labels are read back by eye
+         h ^= (uint8_t)ch;
+         h *= 16777619U;
+     }
+     return h ? h : 1;                           // 0 marks an empty slot
+ }
+ 
+ static void totals_add(RunDbTotals* t, const RunDbRecord* r){
+     t->runs++;
+     if(r->mode < RUN_DB_MODES) t->secs[r->mode] += r->duration_s;
+     if(r->timestamp > t->last_ts) t->last_ts = r->timestamp;
+ }
+ 
+ static void totals_merge(RunDbTotals* t, const RunDbTotals* add){
+     t->runs += add->runs;
+     for(uint8_t m = 0; m < RUN_DB_MODES; m++) t->secs[m] += add->secs[m];
+     if(add->last_ts > t->last_ts) t->last_ts = add->last_ts;
+ }
+ 
+ /* ---------- In-RAM index (open addressing, linear probing) ---------- */
+ static RunDbTotals* index_find(RunDb* db, uint32_t h, bool insert){
+     uint16_t i = (uint16_t)(h & (RUN_DB_INDEX - 1));
+     for(uint16_t n = 0; n < RUN_DB_INDEX; n++, i = (i + 1) & (RUN_DB_INDEX - 1)){
+         RunDbTotals* t = &db->index[i];
+         if(t->serial_hash == h) return t;
+         if(t->serial_hash == 0){                // End of the probe chain: not present
+             if(!insert || db->used >= RUN_DB_INDEX_MAX) return NULL;
+             t->serial_hash = h;
+             db->used++;
+             return t;
+         }
+     }
+     return NULL;
+ }
+ 
+ static bool index_add(RunDb* db, const RunDbRecord* r){
+     RunDbTotals* t = index_find(db, r->serial_hash, true);
+     if(!t) return false;                        // Full: caller compacts
+     totals_add(t, r);
+     return true;
+ }
+ 
+ static void index_clear(RunDb* db){
+     memset(db->index, 0, sizeof(db->index));
+     db->used = 0;
+ }
+ 
+ /* ---------- Files ---------- */
+ static bool read_exact(File* f, void* buf, size_t len){ return storage_file_read(f, buf, len) == len; }
+ static bool write_exact(File* f, const void* buf, size_t len){ return storage_file_write(f, buf, len) == len; }
+ 
+ static bool snap_header(RunDb* db, File* f, RunDbSnapHeader* h){ // Open + validate the snapshot
+     return storage_file_open(f, db->idx_path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+            read_exact(f, h, sizeof(*h)) && h->magic == RUN_DB_IDX_MAGIC &&
+            h->version == RUN_DB_VERSION && h->entry_size == sizeof(RunDbTotals);
+ }
+ 
+ static bool journal_reset(RunDb* db){           // New, empty journal of the current epoch
+     File* f = storage_file_alloc(db->storage);
+     RunDbJournalHeader h = {.magic = RUN_DB_JNL_MAGIC, .epoch = db->epoch};
+     bool ok = storage_file_open(f, db->jnl_path, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+               write_exact(f, &h, sizeof(h));
+     storage_file_close(f);
+     storage_file_free(f);
+     db->journal_records = 0;
+     db->folded = 0;
+     return ok;
+ }
+ 
+ /* Merge the index into a new sorted snapshot. new_epoch/new_folded describe what the
+  * snapshot covers once the rename lands. The index itself is left untouched on failure. */
+ static bool fold(RunDb* db, uint32_t new_epoch, uint32_t new_folded){
+     uint8_t order[RUN_DB_INDEX_MAX];            // Occupied slots, insertion-sorted by hash
+     uint8_t n = 0;
+     for(uint8_t i = 0; i < RUN_DB_INDEX; i++){
+         if(db->index[i].serial_hash == 0 || n >= RUN_DB_INDEX_MAX) continue;
+         uint8_t j = n++;
+         while(j > 0 && db->index[order[j - 1]].serial_hash > db->index[i].serial_hash){
+             order[j] = order[j - 1];
+             j--;
+         }
+         order[j] = i;
+     }
+ 
+     File* in = storage_file_alloc(db->storage);
+     File* out = storage_file_alloc(db->storage);
+     RunDbSnapHeader ih;
+     uint32_t in_left = snap_header(db, in, &ih) ? ih.count : 0;
+     RunDbSnapHeader oh = {
+         .magic = RUN_DB_IDX_MAGIC, .version = RUN_DB_VERSION, .entry_size = sizeof(RunDbTotals),
+         .epoch = new_epoch, .folded = new_folded, .count = 0,
+     };
+     bool ok = storage_file_open(out, db->tmp_path, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+               write_exact(out, &oh, sizeof(oh)); // Count patched in at the end
+ 
+     RunDbTotals cur;                            // Streamed snapshot entry
+     bool have = ok && in_left && read_exact(in, &cur, sizeof(cur));
+     if(in_left && !have) ok = false;            // Unreadable snapshot: keep the old one
+     uint8_t k = 0;
+     while(ok && (have || k < n)){
+         const RunDbTotals* add = (k < n) ? &db->index[order[k]] : NULL;
+         if(have && (!add || cur.serial_hash <= add->serial_hash)){
+             if(add && cur.serial_hash == add->serial_hash){ totals_merge(&cur, add); k++; }
+             ok = write_exact(out, &cur, sizeof(cur));
+             have = --in_left && read_exact(in, &cur, sizeof(cur));
+             if(in_left && !have) ok = false;    // Read error: a partial merge would lose entries
+         } else {
+             ok = write_exact(out, add, sizeof(*add));
+             k++;
+         }
+         oh.count++;
+     }
+     ok = ok && storage_file_seek(out, 0, true) && write_exact(out, &oh, sizeof(oh));
+     storage_file_close(in);
+     storage_file_free(in);
+     storage_file_close(out);
+     storage_file_free(out);
+ 
+     if(ok){                                     // Swap in the new snapshot
+         storage_common_remove(db->storage, db->idx_path);
+         ok = storage_common_rename(db->storage, db->tmp_path, db->idx_path) == FSE_OK;
+     }
+     if(!ok){
+         storage_common_remove(db->storage, db->tmp_path);
+         return false;
+     }
+     index_clear(db);
+     return true;
+ }
+ 
+ static bool compact(RunDb* db){                 // Everything into the snapshot, new journal
+     if(!fold(db, db->epoch + 1, 0)) return false;
+     db->epoch++;                                // From here the old journal is stale
+     return journal_reset(db);
+ }
+ 
+ static bool compact_due(const RunDb* db){
+     return db->journal_records >= RUN_DB_COMPACT_AT ||
+            db->used > RUN_DB_INDEX_MAX - RUN_DB_PENDING; // Next session could fill the index
+ }
+ 
+ static void snap_recover(RunDb* db){            // Crash between remove and rename in fold()
+     File* f = storage_file_alloc(db->storage);
+     RunDbSnapHeader h;
+     bool have_idx = snap_header(db, f, &h);
+     storage_file_close(f);
+     bool tmp_ok = !have_idx &&                  // Only a complete file: count is patched last
+         storage_file_open(f, db->tmp_path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+         read_exact(f, &h, sizeof(h)) && h.magic == RUN_DB_IDX_MAGIC &&
+         h.version == RUN_DB_VERSION && h.entry_size == sizeof(RunDbTotals) &&
+         storage_file_size(f) == sizeof(h) + (uint64_t)h.count * sizeof(RunDbTotals);
+     storage_file_close(f);
+     storage_file_free(f);
+     if(tmp_ok) storage_common_rename(db->storage, db->tmp_path, db->idx_path);
+     else storage_common_remove(db->storage, db->tmp_path); // Torn or superseded
+ }
+ 
+ /* ---------- Public API ---------- */
+ void run_db_open(RunDb* db, Storage* storage, const char* dir){
+     memset(db, 0, sizeof(*db));
+     db->storage = storage;
+     snprintf(db->jnl_path, sizeof(db->jnl_path), "%s/runs.jnl", dir);
+     snprintf(db->idx_path, sizeof(db->idx_path), "%s/runs.idx", dir);
+     snprintf(db->tmp_path, sizeof(db->tmp_path), "%s/runs.tmp", dir);
+     snap_recover(db);
+ 
+     File* f = storage_file_alloc(storage);
+     RunDbSnapHeader sh;
+     if(snap_header(db, f, &sh)){                // No snapshot yet: epoch 0, nothing folded
+         db->epoch = sh.epoch;
+         db->folded = sh.folded;
+     }
+     storage_file_close(f);
+ 
+     RunDbJournalHeader jh;
+     bool journal_ok = storage_file_open(f, db->jnl_path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+                       read_exact(f, &jh, sizeof(jh)) && jh.magic == RUN_DB_JNL_MAGIC &&
+                       jh.epoch == db->epoch;    // Other epoch: already folded before a crash
+     bool compact_now = false;
+     if(journal_ok){
+         uint32_t skip = db->folded;             // Prefix already in the snapshot
+         uint32_t got;
+         while((got = storage_file_read(f, db->pending, sizeof(db->pending)) / sizeof(RunDbRecord)) > 0){
+             for(uint32_t i = 0; i < got; i++){  // pending[] doubles as the read buffer here
+                 db->journal_records++;
+                 if(skip){ skip--; continue; }
+                 if(index_add(db, &db->pending[i])) continue;
+                 /* Index full: fold what we have, note how far we got, carry on */
+                 if(!fold(db, db->epoch, db->journal_records - 1)) break;
+                 db->folded = db->journal_records - 1;
+                 index_add(db, &db->pending[i]);
+                 compact_now = true;
+             }
+         }
+     }
+     storage_file_close(f);
+     storage_file_free(f);
+     memset(db->pending, 0, sizeof(db->pending));
+ 
+     if(!journal_ok){                            // Missing, foreign or stale journal
+         index_clear(db);
+         journal_reset(db);
+     } else if(compact_now || compact_due(db)){
+         compact(db);
+     }
+ }
+ 
+ void run_db_flush(RunDb* db){
+     if(db->n_pending == 0) return;
+     File* f = storage_file_alloc(db->storage);
+     if(storage_file_open(f, db->jnl_path, FSAM_WRITE, FSOM_OPEN_APPEND) &&
+        write_exact(f, db->pending, db->n_pending * sizeof(RunDbRecord))){
+         db->journal_records += db->n_pending;
+     }
+     storage_file_close(f);
+     storage_file_free(f);
+     db->n_pending = 0;                          // A failed card loses these runs, not the index
+ }
+ 
+ bool run_db_append(RunDb* db, uint32_t serial_hash, uint8_t mode, uint32_t duration_s, uint32_t ts){
+     RunDbRecord r = {.serial_hash = serial_hash, .timestamp = ts, .duration_s = duration_s, .mode = mode};
+     RunDbTotals* t = index_find(db, serial_hash, true); // Room kept by run_db_service()
+     if(t && db->n_pending < RUN_DB_PENDING){
+         totals_add(t, &r);
+         db->pending[db->n_pending++] = r;
+         return true;
+     }
+     for(uint8_t i = db->n_pending; t && i-- > 0; ){ // Full: many changes in one session
+         RunDbRecord* p = &db->pending[i];
+         if(p->serial_hash != serial_hash || p->mode != mode) continue;
+         p->duration_s += duration_s;            // Same unit and speed: one longer run
+         if(ts > p->timestamp) p->timestamp = ts;
+         if(mode < RUN_DB_MODES) t->secs[mode] += duration_s;
+         if(ts > t->last_ts) t->last_ts = ts;
+         return true;
+     }
+     if(db->dropped < UINT16_MAX) db->dropped++;
+     return false;
+ }
+ 
+ void run_db_service(RunDb* db){
+     run_db_flush(db);
+     if(compact_due(db)) compact(db);
+ }
+ 
+ void run_db_close(RunDb* db){
+     run_db_service(db);
+ }
+ 
+ bool run_db_lookup(RunDb* db, uint32_t serial_hash, RunDbTotals* out){
+     memset(out, 0, sizeof(*out));
+     out->serial_hash = serial_hash;
+     bool found = false;
+ 
+     File* f = storage_file_alloc(db->storage);  // Binary search, one entry per probe
+     RunDbSnapHeader h;
+     if(snap_header(db, f, &h)){
+         uint32_t lo = 0, hi = h.count;
+         while(lo < hi){
+             uint32_t mid = lo + (hi - lo) / 2;
+             RunDbTotals e;
+             if(!storage_file_seek(f, sizeof(h) + mid * sizeof(e), true) || !read_exact(f, &e, sizeof(e))) break;
+             if(e.serial_hash == serial_hash){ *out = e; found = true; break; }
+             if(e.serial_hash < serial_hash) lo = mid + 1;
+             else hi = mid;
+         }
+     }
+     storage_file_close(f);
+     storage_file_free(f);
+ 
+     RunDbTotals* t = index_find(db, serial_hash, false); // Runs since the last compaction
+     if(t){
+         totals_merge(out, t);
+         found = true;
+     }
+     return found;
+ }
@@ -0,0 +1,77 @@
+/*******************************************************************************************
+ * Expert Tool ICS — run-hours database (SD card)
+ * -----------------------------------------------------------------------------------------
+ * Cumulative runtime per compressor serial, split per speed, across any number of
+ * sessions. Two files:
+ *  - runs.jnl: append-only journal of fixed 16-byte records (serial hash, mode,
+ *    duration, RTC timestamp). New runs only ever append.
+ *  - runs.idx: snapshot of per-unit totals sorted by serial hash. A lookup is a binary
+ *    search with seeks of one entry each, so it needs the same memory for 10 units or
+ *    10 000.
+ * At launch the journal tail is folded into a fixed-size in-RAM hash index (open
+ * addressing). A lookup combines one snapshot entry with one index slot. Compaction
+ * merges the index into a new sorted snapshot (streamed: one entry in, one entry out)
+ * and starts a new journal. Appending a run never touches the card: journal writes and
+ * compaction happen in run_db_service() (called while the output is off), at launch and
+ * at exit. The service keeps enough index room free for a whole session of new units.
+ *
+ * Crash safety: the snapshot header records which journal generation (epoch) it covers
+ * and how many of its records are already folded in. A journal whose epoch differs from
+ * the snapshot was completely folded before a crash and is discarded, so no run is
+ * counted twice. A new snapshot is written to runs.tmp first; if a crash lands between
+ * removing the old runs.idx and the rename, the next open finds the complete runs.tmp
+ * and finishes the rename.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include <storage/storage.h>                    // SD access
+ #include <stdbool.h>                            // bool
+ #include <stdint.h>                             // Fixed-width integers
+ 
+ #define RUN_DB_MODES       6                    // Mode rows tracked (= PROFILE_MAX_MODES)
+ #define RUN_DB_INDEX       64                   // Hash slots in RAM (power of two)
+ #define RUN_DB_INDEX_MAX   48                   // Units before the index counts as full (75 %)
+ #define RUN_DB_PENDING     16                   // Records buffered before a journal write
+ #define RUN_DB_COMPACT_AT  512                  // Journal records that trigger compaction
+ #define RUN_DB_PATH_LEN    96
+ 
+ typedef struct {
+     uint32_t serial_hash;                       // run_db_hash(serial), never 0
+     uint32_t timestamp;                         // RTC Unix time at the end of the run
+     uint32_t duration_s;                        // Time spent in this mode
+     uint8_t  mode;                              // Mode row (1.. : speeds; 0 unused)
+     uint8_t  reserved[3];
+ } RunDbRecord;                                  // Journal entry: 16 bytes
+ 
+ typedef struct {
+     uint32_t serial_hash;                       // 0 = empty index slot
+     uint32_t runs;                              // Records folded in
+     uint32_t last_ts;                           // Most recent run (RTC Unix time)
+     uint32_t secs[RUN_DB_MODES];                // Total seconds per mode row
+ } RunDbTotals;                                  // Snapshot entry / index slot: 36 bytes
+ 
+ typedef struct {
+     RunDbTotals index[RUN_DB_INDEX];            // Journal tail, by hash
+     uint16_t used;                              // Occupied slots
+     RunDbRecord pending[RUN_DB_PENDING];        // Appended, not yet on the card
+     uint8_t n_pending;
+     uint32_t epoch;                             // Journal generation (matches the snapshot)
+     uint32_t folded;                            // Journal records already in the snapshot
+     uint32_t journal_records;                   // Records in the journal file
+     uint16_t dropped;                           // Runs that found no room (see run_db_append)
+     Storage* storage;
+     char jnl_path[RUN_DB_PATH_LEN];
+     char idx_path[RUN_DB_PATH_LEN];
+     char tmp_path[RUN_DB_PATH_LEN];
+ } RunDb;
+ 
+ uint32_t run_db_hash(const char* serial);       // FNV-1a, case-folded, never 0
+ void run_db_open(RunDb* db, Storage* storage, const char* dir); // Build the index (may compact)
+ void run_db_close(RunDb* db);                   // Flush; compact when due (as run_db_service)
+ /* RAM only, never touches the card. With the pending buffer full, the run is merged into
+  * a pending run of the same unit and mode (hours kept, run count not). Returns false if
+  * the run could not be recorded at all (counted in dropped). */
+ bool run_db_append(RunDb* db, uint32_t serial_hash, uint8_t mode, uint32_t duration_s, uint32_t ts);
+ void run_db_flush(RunDb* db);                   // Write pending records in one append
+ void run_db_service(RunDb* db);                 // Output off: flush, compact when due
+ bool run_db_lookup(RunDb* db, uint32_t serial_hash, RunDbTotals* out); // false: unit unknown
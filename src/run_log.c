@@ -0,0 +1,157 @@
+/*******************************************************************************************
+ * Expert Tool ICS — asynchronous run log (see run_log.h)
+ *******************************************************************************************/
+ #include "run_log.h"
+ #include <furi_hal.h>                           // RTC date/time
+ #include <stdio.h>                              // snprintf
+ #include <string.h>                             // memcpy, memset
+ 
+ #define RUN_LOG_FLAG_DATA (1U << 0)             // Ring is half full: drain early
+ #define RUN_LOG_FLAG_STOP (1U << 1)             // Drain everything and exit
+ #define RUN_LOG_PATH_LEN  96
+ 
+ static const char* const kKindNames[] = {
+     [RunLogPowerOn]  = "power on ",
+     [RunLogMode]     = "mode     ",
+     [RunLogAutoOff]  = "auto-off ",
+     [RunLogPowerOff] = "power off",
+     [RunLogError]    = "error    ",
+     [RunLogBattery]  = "battery  ",
+ };
+ 
+ /* ---------- Control side ---------- */
+ void run_log_event(RunLog* rl, RunLogKind kind, uint16_t freq_hz, const char* text){
+     uint16_t head = rl->head;                   // Ours: no ordering needed
+     uint16_t tail = __atomic_load_n(&rl->tail, __ATOMIC_ACQUIRE); // Writer is done with the slot
+     uint16_t next = (head + 1) & (RUN_LOG_EVENTS - 1);
+     if(next == tail){                       // Writer stalled: keep old events, count the loss
+         if(rl->dropped != UINT16_MAX) rl->dropped++;
+         return;
+     }
+     RunLogEvent* e = &rl->ring[head];
+     e->tick = furi_get_tick();
+     snprintf(e->text, sizeof(e->text), "%s", text ? text : ""); // "" = no text
+     e->freq_hz = freq_hz;
+     e->kind = (uint8_t)kind;
+     __atomic_store_n(&rl->head, next, __ATOMIC_RELEASE); // Publish after the slot is written
+     if(((next - tail) & (RUN_LOG_EVENTS - 1)) >= RUN_LOG_EVENTS / 2){
+         furi_thread_flags_set(furi_thread_get_id(rl->thread), RUN_LOG_FLAG_DATA);
+     }
+ }
+ 
+ /* ---------- Writer side ---------- */
+ static void mkdir_parents(Storage* storage, const char* dir){ // "/ext/a/b" -> /ext/a, /ext/a/b
+     char path[RUN_LOG_PATH_LEN];
+     snprintf(path, sizeof(path), "%s", dir);
+     for(char* p = strchr(path + 1, '/'); p; p = strchr(p + 1, '/')){
+         *p = '\0';
+         if(strchr(path + 1, '/')) storage_simply_mkdir(storage, path); // Skip the mount point
+         *p = '/';
+     }
+     storage_simply_mkdir(storage, path);
+ }
+ 
+ static bool log_open(RunLog* rl){               // First event: create the session file
+     char path[RUN_LOG_PATH_LEN];
+     const DateTime* t = &rl->t0;
+     mkdir_parents(rl->storage, rl->dir);
+     snprintf(path, sizeof(path), "%s/run_%04u%02u%02u_%02u%02u%02u.log", rl->dir,
+         t->year, t->month, t->day, t->hour, t->minute, t->second);
+     rl->file = storage_file_alloc(rl->storage);
+     if(!storage_file_open(rl->file, path, FSAM_WRITE, FSOM_OPEN_APPEND)){
+         storage_file_free(rl->file);
+         rl->file = NULL;
+         return false;
+     }
+     return true;
+ }
+ 
+ static void log_flush(RunLog* rl){              // Hand the pending block to the card
+     if(rl->fill == 0) return;
+     if(!rl->failed && !rl->file && !log_open(rl)) rl->failed = true;
+     if(!rl->failed && storage_file_write(rl->file, rl->block, rl->fill) != rl->fill) rl->failed = true;
+     rl->fill = 0;                               // Failed card: drop the text, keep draining
+ }
+ 
+ static void log_line(RunLog* rl, const char* line, int len){
+     if(len <= 0) return;
+     if((size_t)len >= sizeof(rl->block)) len = sizeof(rl->block) - 1;
+     if(rl->fill + len > RUN_LOG_BLOCK) log_flush(rl); // Full block: one write
+     memcpy(rl->block + rl->fill, line, (size_t)len);
+     rl->fill = (uint16_t)(rl->fill + len);
+ }
+ 
+ static void log_drain(RunLog* rl){              // Format everything queued so far
+     char line[80];
+     const uint32_t hz = furi_kernel_get_tick_frequency();
+     uint16_t tail = rl->tail;                   // Ours: no ordering needed
+     while(tail != __atomic_load_n(&rl->head, __ATOMIC_ACQUIRE)){ // Slot contents visible
+         RunLogEvent e = rl->ring[tail];
+         tail = (tail + 1) & (RUN_LOG_EVENTS - 1);
+         __atomic_store_n(&rl->tail, tail, __ATOMIC_RELEASE); // Free the slot after copying
+         if(rl->fill == 0 && !rl->file && !rl->failed){    // Header opens a new file
+             const DateTime* t = &rl->t0;
+             log_line(rl, line, snprintf(line, sizeof(line),
+                 "# Expert Tool ICS run log %04u-%02u-%02u %02u:%02u:%02u\n",
+                 t->year, t->month, t->day, t->hour, t->minute, t->second));
+         }
+         uint32_t ms = (uint32_t)((uint64_t)(e.tick - rl->t0_tick) * 1000U / hz);
+         int n = snprintf(line, sizeof(line), "%6lu.%03lu  %s", (unsigned long)(ms / 1000U),
+             (unsigned long)(ms % 1000U), kKindNames[e.kind]);
+         if(e.text[0] && n > 0 && n < (int)sizeof(line)){
+             n += snprintf(line + n, sizeof(line) - n, "  %s", e.text);
+         }
+         if(e.kind == RunLogMode && n > 0 && n < (int)sizeof(line)){
+             n += snprintf(line + n, sizeof(line) - n, " (%u Hz)", e.freq_hz);
+         }
+         if(n < 0) continue;
+         if(n >= (int)sizeof(line) - 1) n = sizeof(line) - 2; // Truncated: still end the line
+         line[n++] = '\n';
+         log_line(rl, line, n);
+     }
+     uint16_t dropped = rl->dropped;             // Report losses once the ring has room again
+     if(dropped != rl->dropped_logged){
+         log_line(rl, line, snprintf(line, sizeof(line), "# %u event(s) dropped%s\n",
+             dropped - rl->dropped_logged, (dropped == UINT16_MAX) ? " (or more)" : ""));
+         rl->dropped_logged = dropped;
+     }
+ }
+ 
+ static int32_t run_log_thread(void* ctx){
+     RunLog* rl = ctx;
+     rl->storage = furi_record_open(RECORD_STORAGE);
+     for(bool stop = false; !stop; ){
+         uint32_t flags = furi_thread_flags_wait(RUN_LOG_FLAG_DATA | RUN_LOG_FLAG_STOP,
+             FuriFlagWaitAny, furi_ms_to_ticks(RUN_LOG_IDLE_MS));
+         bool idle = (flags & FuriFlagError) != 0; // Timeout: nothing new for a while
+         stop = !idle && (flags & RUN_LOG_FLAG_STOP);
+         log_drain(rl);
+         if(idle || stop) log_flush(rl);         // Quiet or exiting: partial block goes out
+     }
+     if(rl->file){
+         storage_file_close(rl->file);
+         storage_file_free(rl->file);
+         rl->file = NULL;
+     }
+     furi_record_close(RECORD_STORAGE);
+     return 0;
+ }
+ 
+ /* ---------- Public API ---------- */
+ void run_log_start(RunLog* rl, const char* dir){
+     memset(rl, 0, sizeof(*rl));
+     rl->dir = dir;
+     rl->t0_tick = furi_get_tick();
+     furi_hal_rtc_get_datetime(&rl->t0);
+     rl->thread = furi_thread_alloc_ex("IcsRunLog", 1536, run_log_thread, rl);
+     furi_thread_set_priority(rl->thread, FuriThreadPriorityLow); // Below GUI and input
+     furi_thread_start(rl->thread);
+ }
+ 
+ void run_log_stop(RunLog* rl){
+     if(!rl->thread) return;
+     furi_thread_flags_set(furi_thread_get_id(rl->thread), RUN_LOG_FLAG_STOP);
+     furi_thread_join(rl->thread);
+     furi_thread_free(rl->thread);
+     rl->thread = NULL;
+ }
@@ -0,0 +1,63 @@
+/*******************************************************************************************
+ * Expert Tool ICS — asynchronous run log (SD card)
+ * -----------------------------------------------------------------------------------------
+ * Power on, every mode change, auto-off, power off, errors and (while powered) each
+ * battery telemetry sample become one timestamped line in a per-session text log. The
+ * control path only copies a 32-byte event into a single-producer ring: no lock, no
+ * storage call, never blocks. A low-priority writer thread formats the events and
+ * writes them to the card in block-sized batches (a partial block goes out once the log
+ * has been idle for RUN_LOG_IDLE_MS). If the card stalls and the ring fills up, new
+ * events are counted in a saturating drop counter, and the count is logged once the
+ * writer catches up. The file is created on the first event, so sessions that never
+ * power the output leave no file behind.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include <furi.h>                               // Writer thread
+ #include <storage/storage.h>                    // Log file
+ #include <datetime/datetime.h>                  // DateTime (session start)
+ #include <stdbool.h>                            // bool
+ #include <stdint.h>                             // Fixed-width integers
+ 
+ #define RUN_LOG_EVENTS  32                      // Ring capacity (power of two)
+ #define RUN_LOG_BLOCK   512                     // Write batch: one SD sector
+ #define RUN_LOG_IDLE_MS 2000                    // Flush a partial block after this much quiet
+ #define RUN_LOG_TEXT    24                      // Event text incl. NUL (longer is cut)
+ 
+ typedef enum {
+     RunLogPowerOn,                              // text = profile name
+     RunLogMode,                                 // text = mode label, freq_hz
+     RunLogAutoOff,                              // text = label of the mode that timed out
+     RunLogPowerOff,                             // Output cut (user, help, profile change)
+     RunLogError,                                // text = what went wrong
+     RunLogBattery,                              // text = telemetry sample (mV, mA, °C)
+ } RunLogKind;
+ 
+ typedef struct {
+     uint32_t tick;                              // furi_get_tick() when it happened
+     char text[RUN_LOG_TEXT];                    // Copied: names may change before the write
+     uint16_t freq_hz;                           // Commanded frequency (RunLogMode)
+     uint8_t kind;                               // RunLogKind
+     uint8_t reserved;
+ } RunLogEvent;
+ 
+ typedef struct {
+     RunLogEvent ring[RUN_LOG_EVENTS];           // Written by the control thread only
+     volatile uint16_t head;                     // Next slot the control thread writes
+     volatile uint16_t tail;                     // Next slot the writer reads
+     volatile uint16_t dropped;                  // Events lost to a full ring (saturates)
+     uint16_t dropped_logged;                    // Writer: part of dropped already reported
+     const char* dir;                            // Log directory (created on first event)
+     uint32_t t0_tick;                           // Session start: line timestamps are relative
+     DateTime t0;                                // Wall clock at session start (file name)
+     FuriThread* thread;                         // Writer
+     Storage* storage;                           // Writer-owned from here on
+     File* file;                                 // NULL until the first event is written
+     bool failed;                                // Card missing / full: discard from now on
+     uint16_t fill;                              // Bytes pending in block
+     char block[RUN_LOG_BLOCK];                  // Formatted lines waiting for the card
+ } RunLog;
+ 
+ void run_log_start(RunLog* rl, const char* dir); // Start the writer; no file yet
+ void run_log_stop(RunLog* rl);                  // Drain, close the file, join the writer
+ void run_log_event(RunLog* rl, RunLogKind kind, uint16_t freq_hz, const char* text); // Lock-free
@@ -0,0 +1,95 @@
+/*******************************************************************************************
+ * Expert Tool ICS — battery / OTG telemetry (see telemetry.h)
+ *******************************************************************************************/
+ #include "telemetry.h"
+ #include <furi.h>                               // furi_get_tick(), furi_ms_to_ticks()
+ #include <furi_hal.h>                           // Fuel gauge and OTG state
+ #include <string.h>                             // memset
+ 
+ static void stat_clear(TelemetryStat* s){
+     s->min = INT32_MAX;                         // Any sample will replace these
+     s->max = INT32_MIN;
+     s->sum = 0;
+     s->n = 0;
+ }
+ 
+ static void stat_add(TelemetryStat* s, int32_t v){ // O(1) incremental update
+     if(v < s->min) s->min = v;
+     if(v > s->max) s->max = v;
+     s->sum += v;
+     s->n++;
+ }
+ 
+ void telemetry_reset_stats(Telemetry* t){
+     stat_clear(&t->mv);
+     stat_clear(&t->ma);
+     stat_clear(&t->temp);
+ }
+ 
+ void telemetry_reset(Telemetry* t, uint32_t period_ms){
+     memset(t, 0, sizeof(*t));                   // Empty ring, no sink
+     t->period_ms = period_ms;
+     t->last_tick = furi_get_tick() - furi_ms_to_ticks(period_ms); // Sample on first poll
+     telemetry_reset_stats(t);
+ }
+ 
+ void telemetry_set_period(Telemetry* t, uint32_t period_ms){ t->period_ms = period_ms; }
+ 
+ void telemetry_set_sink(Telemetry* t, TelemetrySink sink, void* ctx){
+     t->sink = sink;
+     t->sink_ctx = ctx;
+ }
+ 
+ bool telemetry_poll(Telemetry* t){
+     uint32_t now = furi_get_tick();
+     if(now - t->last_tick < furi_ms_to_ticks(t->period_ms)) return false; // Not due yet
+     t->last_tick = now;
+ 
+     TelemetrySample* s = &t->ring[t->head];     // Fill next slot in place
+     s->t_ms    = now;
+     s->batt_mv = (uint16_t)(furi_hal_power_get_battery_voltage(FuriHalPowerICFuelGauge) * 1000.0f);
+     s->batt_ma = (int16_t)(-furi_hal_power_get_battery_current(FuriHalPowerICFuelGauge) * 1000.0f);
+     s->temp_dc = (int16_t)(furi_hal_power_get_battery_temperature(FuriHalPowerICFuelGauge) * 10.0f);
+     s->otg     = furi_hal_power_is_otg_enabled();
+ 
+     t->head = (uint16_t)((t->head + 1) % TELEMETRY_SAMPLES);
+     if(t->count < TELEMETRY_SAMPLES) t->count++;
+ 
+     stat_add(&t->mv, s->batt_mv);               // Session aggregates
+     stat_add(&t->ma, s->batt_ma);
+     stat_add(&t->temp, s->temp_dc);
+ 
+     uint8_t k = s->otg ? 1 : 0;                 // Separate EMA per load profile
+     int32_t x16 = (int32_t)s->batt_ma * 16;     // Fixed point, 1/16 mA
+     if(t->ema_n[k] == 0) t->ema_ma_x16[k] = x16; // Seed with the first reading
+     else t->ema_ma_x16[k] += (x16 - t->ema_ma_x16[k]) >> TELEMETRY_EMA_SHIFT;
+     if(t->ema_n[k] < UINT16_MAX) t->ema_n[k]++;
+ 
+     t->remaining_mah = (uint16_t)furi_hal_power_get_battery_remaining_capacity();
+     t->full_mah      = (uint16_t)furi_hal_power_get_battery_full_capacity();
+ 
+     if(t->sink) t->sink(s, t->sink_ctx);        // Hand to logging path, if any
+     return true;
+ }
+ 
+ uint32_t telemetry_runtime_s(const Telemetry* t, bool otg){
+     uint8_t k = otg ? 1 : 0;
+     if(t->ema_n[k] < TELEMETRY_EMA_MIN_N) return TELEMETRY_RUNTIME_UNKNOWN; // Not settled yet
+     int32_t ma_x16 = t->ema_ma_x16[k];
+     if(ma_x16 <= 0) return TELEMETRY_RUNTIME_UNKNOWN; // Charging or idle: no limit
+ 
+     uint32_t reserve = (uint32_t)t->full_mah * TELEMETRY_RESERVE_PCT / 100U;
+     if(t->remaining_mah <= reserve) return 0;   // Already into the margin
+     uint32_t usable = t->remaining_mah - reserve; // mAh until cutoff margin
+     return (uint32_t)(((uint64_t)usable * 3600U * 16U) / (uint32_t)ma_x16); // h -> s, undo x16
+ }
+ 
+ const TelemetrySample* telemetry_get(const Telemetry* t, uint16_t i){
+     if(i >= t->count) return NULL;
+     uint16_t start = (uint16_t)((t->head + TELEMETRY_SAMPLES - t->count) % TELEMETRY_SAMPLES);
+     return &t->ring[(start + i) % TELEMETRY_SAMPLES];
+ }
+ 
+ const TelemetrySample* telemetry_latest(const Telemetry* t){
+     return t->count ? telemetry_get(t, (uint16_t)(t->count - 1)) : NULL;
+ }
@@ -0,0 +1,81 @@
+/*******************************************************************************************
+ * Expert Tool ICS — battery / OTG telemetry
+ * -----------------------------------------------------------------------------------------
+ * Samples the fuel gauge (voltage, current, temperature) and the OTG 5V state at a
+ * configurable period into a fixed-size ring buffer. Session min/avg/max are updated
+ * incrementally per sample (no rescans). Consumers read the ring or register a sink.
+ *******************************************************************************************/
+ #pragma once
+ 
+ #include <stdbool.h>                            // bool
+ #include <stdint.h>                             // Fixed-width integers
+ 
+ #define TELEMETRY_SAMPLES 64                    // Ring capacity (64 s at the 1 s default)
+ #define TELEMETRY_RUNTIME_UNKNOWN UINT32_MAX    // telemetry_runtime_s(): no estimate
+ #define TELEMETRY_RESERVE_PCT 5                 // Capacity kept back as brown-out margin
+ #define TELEMETRY_EMA_SHIFT 3                   // Draw EMA weight 1/8 per sample
+ #define TELEMETRY_EMA_MIN_N 3                   // Samples needed before the EMA is trusted
+ 
+ typedef struct {
+     uint32_t t_ms;                              // Sample time (furi tick, ms)
+     uint16_t batt_mv;                           // Battery voltage, mV
+     int16_t  batt_ma;                           // Battery current, mA (positive = discharging)
+     int16_t  temp_dc;                           // Battery temperature, 0.1 °C
+     bool     otg;                               // OTG 5V rail enabled at sample time
+ } TelemetrySample;
+ 
+ typedef struct {
+     int32_t  min;                               // Smallest value seen
+     int32_t  max;                               // Largest value seen
+     int64_t  sum;                               // Running sum (avg = sum / n)
+     uint32_t n;                                 // Samples accumulated
+ } TelemetryStat;
+ 
+ typedef void (*TelemetrySink)(const TelemetrySample* sample, void* ctx); // Per-sample hook
+ 
+ typedef struct {
+     TelemetrySample ring[TELEMETRY_SAMPLES];    // History (oldest overwritten)
+     uint16_t head;                              // Next write slot
+     uint16_t count;                             // Valid samples
+ 
+     TelemetryStat mv;                           // Session voltage stats
+     TelemetryStat ma;                           // Session current stats
+     TelemetryStat temp;                         // Session temperature stats
+ 
+     int32_t  ema_ma_x16[2];                     // Smoothed draw per OTG state (mA * 16)
+     uint16_t ema_n[2];                          // Samples folded into each EMA
+     uint16_t remaining_mah;                     // Fuel gauge: remaining capacity
+     uint16_t full_mah;                          // Fuel gauge: full-charge capacity
+ 
+     uint32_t period_ms;                         // Sampling period
+     uint32_t last_tick;                         // Tick of the last sample
+ 
+     TelemetrySink sink;                         // Optional consumer (logging path)
+     void* sink_ctx;                             // Context for sink
+ } Telemetry;
+ 
+ /* Clear ring and stats; first sample is taken on the next poll */
+ void telemetry_reset(Telemetry* t, uint32_t period_ms);
+ 
+ /* Restart session min/avg/max (ring history is kept) */
+ void telemetry_reset_stats(Telemetry* t);
+ 
+ void telemetry_set_period(Telemetry* t, uint32_t period_ms);
+ void telemetry_set_sink(Telemetry* t, TelemetrySink sink, void* ctx);
+ 
+ /* Call often (main loop): reads the fuel gauge when a period has elapsed.
+  * Returns true if a new sample was stored. Blocks on I2C, keep off timer callbacks. */
+ bool telemetry_poll(Telemetry* t);
+ 
+ /* Seconds until the battery reaches the reserve margin at the smoothed draw measured
+  * in the given OTG state (PWM only vs PWM + 5V). TELEMETRY_RUNTIME_UNKNOWN when the
+  * battery is not draining or too few samples exist in that state. */
+ uint32_t telemetry_runtime_s(const Telemetry* t, bool otg);
+ 
+ /* i = 0 is the oldest sample; NULL if out of range */
+ const TelemetrySample* telemetry_get(const Telemetry* t, uint16_t i);
+ const TelemetrySample* telemetry_latest(const Telemetry* t);
+ 
+ static inline int32_t telemetry_stat_avg(const TelemetryStat* s){
+     return s->n ? (int32_t)(s->sum / (int64_t)s->n) : 0;
+ }
@@ -0,0 +1,101 @@
+/*******************************************************************************************
+ * Expert Tool ICS — host test: fault blink-code decoder against recorded traces
+ * -----------------------------------------------------------------------------------------
+ * Each trace is the line as a logic analyzer saw it: a list of (level, duration) phases
+ * from a Samsung-style board (active low, long blinks = tens). Build and run with
+ * `make -C tests`.
+ *******************************************************************************************/
+ #include "fault_decoder.h"
+ #include <stdio.h>                              // printf
+ 
+ typedef struct {
+     bool level;                                 // Line level during the phase
+     uint32_t us;                                // Phase length
+ } Phase;
+ 
+ #define LIT   false                             // Active low: LED on
+ #define DARK  true
+ #define SHORT {LIT, 300000}, {DARK, 400000}     // Units blink + gap
+ #define LONG  {LIT, 1200000}, {DARK, 400000}    // Tens blink + gap
+ #define PAUSE {DARK, 3000000}                   // Ends a code
+ 
+ static const FaultProfile kProfile = {
+     .name = "Samsung", .on_min_us = 150000, .on_max_us = 2000000, .long_on_us = 900000,
+     .gap_max_us = 1000000, .pause_min_us = 2500000, .active_low = true,
+ };
+ 
+ static int failures;
+ #define CHECK(cond) do { if(!(cond)){ printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while(0)
+ 
+ /* Feeds the phases as edges (a gap phase followed by a pause merges into one off
+  * phase, as on the wire), then lets the idle check close the last group. */
+ static void play(FaultDecoder* d, const Phase* ph, size_t n){
+     uint32_t t = 1000;                          // Arbitrary capture timestamp
+     bool level = DARK;
+     fault_decoder_edge(d, t, level);            // Line idle when capture starts
+     for(size_t i = 0; i < n; i++){
+         if(ph[i].level != level){
+             level = ph[i].level;
+             fault_decoder_edge(d, t, level);
+         }
+         t += ph[i].us;
+     }
+     fault_decoder_idle(d, t);
+ }
+ 
+ /* ---------- Traces ---------- */
+ static const Phase kCode23PartialFirst[] = {    // Capture starts mid-code: "3" is seen first
+     SHORT, SHORT, SHORT, PAUSE,
+     LONG, LONG, SHORT, SHORT, SHORT, PAUSE,
+     LONG, LONG, SHORT, SHORT, SHORT, PAUSE,
+ };
+ 
+ static const Phase kCode4Glitches[] = {         // 20 µs spikes inside and between groups
+     SHORT, {LIT, 20}, {DARK, 200000}, SHORT, PAUSE, // Spike breaks the first group
+     SHORT, SHORT, SHORT, SHORT, PAUSE,
+     {LIT, 20}, PAUSE,                           // Spike in the pause
+     SHORT, SHORT, SHORT, SHORT, PAUSE,
+ };
+ 
+ static const Phase kSteadyOn[] = {              // Board fault LED lit continuously
+     {LIT, 10000000}, {DARK, 3000000}, {LIT, 10000000},
+ };
+ 
+ static const Phase kTooManyTens[] = {           // Noise made of long pulses: 30 "tens"
+     LONG, LONG, LONG, LONG, LONG, LONG, LONG, LONG, LONG, LONG,
+     LONG, LONG, LONG, LONG, LONG, LONG, LONG, LONG, LONG, LONG,
+     LONG, LONG, LONG, LONG, LONG, LONG, LONG, LONG, LONG, LONG, PAUSE,
+ };
+ 
+ #define COUNT(a) (sizeof(a)/sizeof((a)[0]))
+ 
+ int main(void){
+     FaultDecoder d;
+ 
+     fault_decoder_init(&d, &kProfile);          // Partial first group, then confirmed 23
+     play(&d, kCode23PartialFirst, COUNT(kCode23PartialFirst));
+     CHECK(d.last_code == 23);
+     CHECK(d.confirmed == 23);
+     CHECK(d.errors == 0);
+ 
+     fault_decoder_init(&d, &kProfile);          // Glitches are counted, never decoded
+     play(&d, kCode4Glitches, COUNT(kCode4Glitches));
+     CHECK(d.confirmed == 4);
+     CHECK(d.errors == 2);
+ 
+     fault_decoder_init(&d, &kProfile);          // Steady on: no code at all
+     play(&d, kSteadyOn, COUNT(kSteadyOn));
+     CHECK(d.last_code == FAULT_CODE_NONE);
+     CHECK(d.confirmed == FAULT_CODE_NONE);
+     CHECK(d.errors >= 1);
+     CHECK(!fault_decoder_idle(&d, 0xFFFFFFF0U)); // Still lit: no pause
+ 
+     fault_decoder_init(&d, &kProfile);          // Tens overflow: dropped, never 250+
+     play(&d, kTooManyTens, COUNT(kTooManyTens));
+     CHECK(d.last_code == 50);                   // Only the 5 tens after the loss of sync
+     CHECK(d.confirmed == FAULT_CODE_NONE);
+     CHECK(d.errors == 1);
+ 
+     printf("fault_decoder: %s\n", failures ? "FAILED" : "ok");
+     return failures ? 1 : 0;
+ }
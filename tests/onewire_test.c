@@ -0,0 +1,195 @@
+/*******************************************************************************************
+ * Expert Tool ICS — host test: 1-Wire bit layer + DS18B20 against a simulated bus
+ * -----------------------------------------------------------------------------------------
+ * The OneWireHal below drives a cycle-free model of the bus: delay_us() is the only thing
+ * that advances time, and a DS18B20 model watches the master's edges the way the real
+ * part does (datasheet worst-case windows). It flags slots the part would misread:
+ * reset too short, write-1 low too long, read sampled too late, interrupts held off
+ * for longer than one slot. Build and run with `make -C tests`.
+ *******************************************************************************************/
+ #include "onewire.h"
+ #include <stdio.h>                              // printf
+ #include <string.h>                             // memset
+ 
+ #define SIM_PRESENCE_WAIT 60                    // Part waits 15..60 µs after reset, then
+ #define SIM_PRESENCE_LOW  60                    // pulls low for 60..240 µs (worst case)
+ #define SIM_READ0_HOLD    15                    // Part holds a 0 at least this long
+ #define SIM_W1_MAX_LOW    15                    // Write 1: released within 15 µs
+ #define SIM_W0_MIN_LOW    60                    // Write 0: low for at least 60 µs
+ #define SIM_LOCK_MAX_US   70                    // onewire.h promise
+ 
+ typedef struct {
+     uint32_t now;                               // Simulated µs
+     bool attached;                              // Probe on the bus
+     bool master_low;                            // Master pulls the bus
+     uint32_t fall;                              // Last master falling edge
+     uint32_t rise;                              // Last master release
+     bool presence;                              // Presence pulse follows the last rise
+     bool hold0;                                 // Part holds the current read slot low
+ 
+     uint8_t rx, rx_bits;                        // Bits written by the master
+     uint8_t cmd_count;                          // Bytes since the last reset
+     bool tx;                                    // Part is sending the scratchpad
+     uint8_t tx_byte, tx_bit;                    // Position in pad[]
+     uint8_t pad[9];                             // Scratchpad (temp LSB/MSB .. CRC)
+     int16_t temp_raw;                           // What the next conversion latches
+     bool skip_convert;                          // Brown-out: conversion never runs
+     bool corrupt;                               // Flip a bit in the next scratchpad read
+ 
+     bool locked;
+     uint32_t lock_t;
+     uint32_t lock_max;                          // Longest interrupts-off span
+     uint16_t violations;                        // Slots the real part would misread
+ } SimBus;
+ 
+ static void pad_set(SimBus* b, int16_t raw){
+     static const uint8_t rest[6] = {0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10}; // TH, TL, config, ...
+     b->pad[0] = (uint8_t)raw;
+     b->pad[1] = (uint8_t)((uint16_t)raw >> 8);
+     memcpy(&b->pad[2], rest, sizeof(rest));
+     b->pad[8] = onewire_crc8(b->pad, 8);
+ }
+ 
+ static void sim_byte(SimBus* b, uint8_t v){     // A full byte arrived from the master
+     if(b->cmd_count++ == 0){
+         if(v != 0xCC) b->violations++;          // Only SKIP ROM is expected
+         return;
+     }
+     if(v == 0x44 && !b->skip_convert) pad_set(b, b->temp_raw); // Convert T
+     if(v == 0xBE){                              // Read scratchpad
+         b->tx = true;
+         b->tx_byte = 0;
+         b->tx_bit = 0;
+         if(b->corrupt){ b->pad[0] ^= 0x01; b->corrupt = false; } // CRC now wrong
+     }
+ }
+ 
+ static void sim_set(void* ctx, bool release){
+     SimBus* b = ctx;
+     if(!release && !b->master_low){             // Falling edge: a slot or reset starts
+         b->fall = b->now;
+         b->presence = false;
+         b->hold0 = b->attached && b->tx && !((b->pad[b->tx_byte] >> b->tx_bit) & 1U);
+     } else if(release && b->master_low){        // Rising edge: classify the low time
+         b->rise = b->now;
+         uint32_t low = b->now - b->fall;
+         if(!b->attached){
+             /* Nobody listening */
+         } else if(low >= 480){                  // Reset
+             b->presence = true;
+             b->rx = b->rx_bits = 0;
+             b->cmd_count = 0;
+             b->tx = false;
+         } else if(b->tx){                       // Read slot: next bit
+             if(low > SIM_W1_MAX_LOW) b->violations++;
+             if(++b->tx_bit == 8){ b->tx_bit = 0; if(++b->tx_byte == 9) b->tx = false; }
+         } else {                                // Write slot: the part samples at 15..60 µs
+             bool bit;
+             if(low <= SIM_W1_MAX_LOW) bit = true;
+             else if(low >= SIM_W0_MIN_LOW) bit = false;
+             else { b->violations++; bit = false; } // Undefined: either value possible
+             b->rx |= (uint8_t)(bit << b->rx_bits);
+             if(++b->rx_bits == 8){ sim_byte(b, b->rx); b->rx = b->rx_bits = 0; }
+         }
+     }
+     b->master_low = !release;
+ }
+ 
+ static bool sim_get(void* ctx){
+     SimBus* b = ctx;
+     if(b->master_low) return false;
+     if(b->presence && b->now - b->rise >= SIM_PRESENCE_WAIT &&
+        b->now - b->rise < SIM_PRESENCE_WAIT + SIM_PRESENCE_LOW) return false;
+     if(b->tx && b->now - b->fall > SIM_READ0_HOLD) b->violations++; // Sampled too late
+     if(b->hold0 && b->now - b->fall < SIM_READ0_HOLD + 15) return false;
+     return true;
+ }
+ 
+ static void sim_delay(void* ctx, uint32_t us){ ((SimBus*)ctx)->now += us; }
+ 
+ static void sim_lock(void* ctx, bool on){
+     SimBus* b = ctx;
+     if(on == b->locked) b->violations++;        // Unbalanced
+     if(on) b->lock_t = b->now;
+     else if(b->now - b->lock_t > b->lock_max) b->lock_max = b->now - b->lock_t;
+     b->locked = on;
+ }
+ 
+ static int failures;
+ #define CHECK(cond) do { if(!(cond)){ printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while(0)
+ 
+ static void sim_init(SimBus* b, OneWireHal* h, bool attached){
+     memset(b, 0, sizeof(*b));
+     b->attached = attached;
+     pad_set(b, 0x0550);                         // Power-on scratchpad: 85 °C
+     *h = (OneWireHal){.set = sim_set, .get = sim_get, .delay_us = sim_delay, .lock = sim_lock, .ctx = b};
+ }
+ 
+ int main(void){
+     SimBus b;
+     OneWireHal h;
+     Ds18b20 ds;
+ 
+     /* CRC8: Maxim AN27 example ROM (family 02h, serial 00 00 00 01 B8 1C) */
+     const uint8_t rom[7] = {0x02, 0x1C, 0xB8, 0x01, 0x00, 0x00, 0x00};
+     CHECK(onewire_crc8(rom, sizeof(rom)) == 0xA2);
+ 
+     sim_init(&b, &h, false);                    // Empty bus: no presence
+     CHECK(!onewire_reset(&h));
+     sim_init(&b, &h, true);                     // Probe attached: presence
+     CHECK(onewire_reset(&h));
+ 
+     sim_init(&b, &h, true);                     // Normal conversion: 25.0625 °C
+     b.temp_raw = 0x0191;
+     ds18b20_init(&ds, &h);
+     CHECK(!ds18b20_poll(&ds, 0));               // Starts the conversion
+     CHECK(ds.converting);
+     CHECK(!ds18b20_poll(&ds, 500));             // Not done yet: no bus traffic
+     CHECK(ds18b20_poll(&ds, 800));
+     CHECK(ds.temp_dc == 250);
+     CHECK(ds.t_sample_ms == 1);                 // Latched at conversion start (0 -> 1)
+ 
+     sim_init(&b, &h, true);                     // Brown-out: first read is the 85 °C default
+     b.temp_raw = (int16_t)0xFF5E;               // -10.125 °C
+     b.skip_convert = true;
+     ds18b20_init(&ds, &h);
+     ds18b20_poll(&ds, 0);                       // This conversion is lost
+     b.skip_convert = false;
+     CHECK(!ds18b20_poll(&ds, 800));             // 85 °C discarded
+     CHECK(ds.temp_dc == DS18B20_NO_READING);
+     CHECK(ds18b20_poll(&ds, 1600));
+     CHECK(ds.temp_dc == -101);
+     b.temp_raw = 0x0550;                        // A real 85 °C later on is kept
+     ds18b20_poll(&ds, 2400);
+     CHECK(ds18b20_poll(&ds, 3200) && ds.temp_dc == 850);
+ 
+     sim_init(&b, &h, true);                     // Corrupted read: CRC error, no reading
+     b.temp_raw = 0x0191;
+     ds18b20_init(&ds, &h);
+     ds18b20_poll(&ds, 0);
+     b.corrupt = true;
+     CHECK(!ds18b20_poll(&ds, 800));
+     CHECK(ds.crc_errors == 1);
+     CHECK(ds.temp_dc == DS18B20_NO_READING);
+ 
+     sim_init(&b, &h, false);                    // Absent probe: re-probed only every 3 s
+     ds18b20_init(&ds, &h);
+     ds18b20_poll(&ds, 100);
+     CHECK(!ds.present);
+     uint32_t t = b.now;
+     ds18b20_poll(&ds, 1000);
+     CHECK(b.now == t);                          // No reset pulse sent
+     ds18b20_poll(&ds, 3200);
+     CHECK(b.now > t);
+ 
+     sim_init(&b, &h, true);                     // Every slot type, timing checked
+     b.temp_raw = 0x0191;
+     ds18b20_init(&ds, &h);
+     ds18b20_poll(&ds, 0);
+     ds18b20_poll(&ds, 800);
+     CHECK(b.violations == 0);
+     CHECK(b.lock_max <= SIM_LOCK_MAX_US);
+ 
+     printf("onewire: %s\n", failures ? "FAILED" : "ok");
+     return failures ? 1 : 0;
+ }
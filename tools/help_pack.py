@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""Compress the help texts in src/help/*.txt into src/help_data.c / src/help_data.h.
+
+One .txt file per help document, one screen line per text line (printable ASCII,
+at most HELP_LINE_MAX - 1 characters). All documents share one static dictionary of
+up to 128 substrings, picked greedily by bytes saved. In the packed data a byte
+0x00-0x7F is a literal character and 0x80-0xFF is dictionary entry (byte - 0x80), so
+the app decodes any single line without touching its neighbours.
+
+Usage (from the repository root, after editing the src/help text files):
+    python3 tools/help_pack.py
+"""
+import os
+import sys
+from collections import Counter
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SRC = os.path.join(ROOT, "src")
+HELP_DIR = os.path.join(SRC, "help")
+LINE_MAX = 32                                   # Must match HELP_LINE_MAX in help_text.h
+DICT_MAX = 128                                  # Codes 0x80..0xFF
+TOKEN_MIN, TOKEN_MAX = 2, 16                    # Candidate substring lengths
+ENTRY_COST = 2                                  # uint16 offset per dictionary entry
+
+
+def load_docs():
+    docs = []
+    for name in sorted(os.listdir(HELP_DIR)):
+        if not name.endswith(".txt"):
+            continue
+        with open(os.path.join(HELP_DIR, name), encoding="ascii") as f:
+            lines = f.read().split("\n")
+        if lines and lines[-1] == "":
+            lines.pop()                         # Trailing newline is not a line
+        for n, line in enumerate(lines, 1):
+            if len(line) >= LINE_MAX or any(not 32 <= ord(ch) < 127 for ch in line):
+                sys.exit(f"{name}:{n}: line too long or not printable ASCII")
+        docs.append((os.path.splitext(name)[0], lines))
+    if not docs:
+        sys.exit("no help documents in src/help")
+    return docs
+
+
+def build_dict(docs):
+    """Greedy: repeatedly take the substring that saves the most bytes."""
+    # Each line is a list of segments: str = literal text, int = dictionary code
+    lines = [[l] if l else [] for _, doc in docs for l in doc]
+    words = []
+    while len(words) < DICT_MAX:
+        counts = Counter()
+        for segs in lines:
+            for seg in segs:
+                if isinstance(seg, int):
+                    continue
+                seen = set()                    # Non-overlapping estimate per segment
+                for n in range(TOKEN_MIN, min(TOKEN_MAX, len(seg)) + 1):
+                    for i in range(len(seg) - n + 1):
+                        sub = seg[i:i + n]
+                        if sub not in seen:
+                            seen.add(sub)
+                            counts[sub] += seg.count(sub)
+        best, gain = None, 0
+        for sub, cnt in counts.items():
+            g = cnt * (len(sub) - 1) - len(sub) - ENTRY_COST
+            if g > gain or (g == gain and best is not None and sub < best):
+                best, gain = sub, g
+        if best is None:
+            break
+        code = len(words)
+        words.append(best)
+        for segs in lines:
+            out = []
+            for seg in segs:
+                if isinstance(seg, int):
+                    out.append(seg)
+                    continue
+                parts = seg.split(best)
+                for k, part in enumerate(parts):
+                    if part:
+                        out.append(part)
+                    if k < len(parts) - 1:
+                        out.append(code)
+            segs[:] = out
+    return words, lines
+
+
+def encode(segs):
+    data = bytearray()
+    for seg in segs:
+        if isinstance(seg, int):
+            data.append(0x80 | seg)
+        else:
+            data += seg.encode("ascii")
+    return bytes(data)
+
+
+def c_bytes(data, indent=" " * 5):
+    rows = []
+    for i in range(0, len(data), 16):
+        rows.append(indent + ", ".join(f"0x{b:02X}" for b in data[i:i + 16]) + ",")
+    return "\n".join(rows) if rows else indent + "0x00,"
+
+
+def c_u16(values, indent=" " * 5):
+    rows = []
+    for i in range(0, len(values), 12):
+        rows.append(indent + ", ".join(str(v) for v in values[i:i + 12]) + ",")
+    return "\n".join(rows)
+
+
+def c_name(stem):
+    return "kHelp" + "".join(p.capitalize() for p in stem.replace("-", "_").split("_"))
+
+
+HEADER = """/*******************************************************************************************
+ * Expert Tool ICS — packed help documents
+ * -----------------------------------------------------------------------------------------
+ * GENERATED by tools/help_pack.py from the src/help text files. Do not edit them here;
+ * edit the text files and re-run the script.
+ *******************************************************************************************/
+"""
+
+
+def main():
+    docs = load_docs()
+    words, lines = build_dict(docs)
+    dict_ofs, dict_data = [0], bytearray()
+    for w in words:
+        dict_data += w.encode("ascii")
+        dict_ofs.append(len(dict_data))
+
+    c = [HEADER, ' #include "help_data.h"', " "]
+    c.append(f" static const char kHelpDictText[] =    // {len(words)} entries, {len(dict_data)} bytes")
+    for i in range(0, len(dict_data), 64):
+        chunk = dict_data[i:i + 64].decode("ascii").replace("\\", "\\\\").replace('"', '\\"')
+        c.append(f'     "{chunk}"')
+    c[-1] += ";"
+    c.append(" static const uint16_t kHelpDictOfs[] = {")
+    c.append(c_u16(dict_ofs))
+    c.append(" };")
+    c.append(" const HelpDict kHelpDict = {.text = kHelpDictText, .ofs = kHelpDictOfs, .count = "
+             f"{len(words)}}};")
+
+    h = [HEADER, " #pragma once", " ", ' #include "help_text.h"', " ",
+         " extern const HelpDict kHelpDict;             // Shared by every document"]
+
+    raw_total = packed_total = 0
+    li = 0
+    for stem, doc in docs:
+        name = c_name(stem)
+        data, ofs = bytearray(), [0]
+        for _ in doc:
+            data += encode(lines[li])
+            ofs.append(len(data))
+            li += 1
+        raw = sum(len(l) + 1 for l in doc)
+        raw_total += raw
+        packed_total += len(data) + 2 * len(ofs)
+        c.append(" ")
+        c.append(f" static const uint8_t {name}Data[] = {{ // {len(doc)} lines, {raw} -> {len(data)} bytes")
+        c.append(c_bytes(data))
+        c.append(" };")
+        c.append(f" static const uint16_t {name}Lines[] = {{ // Start of each line + end")
+        c.append(c_u16(ofs))
+        c.append(" };")
+        c.append(f" const HelpDoc {name} = {{.dict = &kHelpDict, .data = {name}Data, "
+                 f".lines = {name}Lines, .count = {len(doc)}}};")
+        h.append(f" extern const HelpDoc {name};")
+
+    with open(os.path.join(SRC, "help_data.c"), "w") as f:
+        f.write("\n".join(c) + "\n")
+    with open(os.path.join(SRC, "help_data.h"), "w") as f:
+        f.write("\n".join(h) + "\n")
+    packed_total += len(dict_data) + 2 * len(dict_ofs)
+    print(f"{len(docs)} docs, {raw_total} bytes of text -> {packed_total} bytes "
+          f"(dictionary {len(words)} entries)")
+
+
+if __name__ == "__main__":
+    main()